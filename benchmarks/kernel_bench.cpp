@@ -0,0 +1,619 @@
+// Microbenchmarks for the hot kernels of the QuadriFlow pipeline, run in
+// isolation on synthetic data: the extrinsic field-math primitives, one
+// phase sweep of the orientation / position smoothers, graph downsampling
+// and the max-flow solve, plus neighbour gathers with and without huge pages.
+//
+//   quadriflow_kernel_bench [filter] [--max-size N] [--min-time SECONDS]
+//                           [--max-threads N]
+//
+// Each kernel runs over a size sweep (1K elements up to --max-size) and
+// reports the best of five batches as ns per element and an effective
+// bandwidth: the bytes an element must touch (inputs read plus outputs
+// written, see the `bytes` column) over its time. The bandwidth figure is a
+// model, not a measurement; use it to compare layouts, not to rank machines.
+//
+// The `*_domains/T` rows time the same sweeps with domain decomposition on a
+// pool of T threads, T doubling up to --max-threads (default: the CPU count
+// this process may use), and the `*_colored/T` rows the default colored
+// sweeps, large phases split over the same pool with a barrier per colour.
+// Compare the two at each T, and both with the serial `*_sweep` rows, for
+// the scaling curves.
+//
+// The `*_colored` and `*_chaotic` rows run a full six-iteration solve of one
+// level on the whole pool, with the default phase sweeps and with chaotic
+// relaxation, and report the time per sweep plus the smoothness energy the
+// solve ends at (the `energy` column: mean squared mismatch over the links,
+// lower is smoother). Chaotic energies vary from run to run.
+//
+// `preview_cold` / `preview_warm` time QuadriFlowSession::preview on the
+// surface as a triangle mesh, per input triangle: the first call of a
+// session, and later calls at another target.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#ifdef _WIN32
+#define _USE_MATH_DEFINES
+#include <math.h>
+#endif
+
+#include "config.hpp"
+#include "field-math.hpp"
+#include "flow.hpp"
+#include "hierarchy.hpp"
+#include "pcg32.h"
+
+#include "hugepages.h"
+#include "numa.h"
+#include "optimizer_kernels.h"
+#include "pipeline.h"
+
+using namespace qflow;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Settings {
+    const char* filter = nullptr;
+    int max_size = 1 << 20;
+    double min_time = 0.02;   // seconds per timed batch
+    int max_threads = NumaCpuCount();
+};
+
+// Keeps results observable so the compiler cannot drop the kernels
+volatile double g_sink = 0;
+
+// Best seconds per run of `run` over five batches of at least min_time each.
+// `setup`, if given, runs untimed before every run.
+double Measure(const Settings& settings, const std::function<void()>& run,
+               const std::function<void()>& setup = nullptr) {
+    auto batch = [&](int reps) {
+        double seconds = 0;
+        for (int r = 0; r < reps; ++r) {
+            if (setup) setup();
+            const Clock::time_point start = Clock::now();
+            run();
+            seconds += std::chrono::duration<double>(Clock::now() - start).count();
+        }
+        return seconds;
+    };
+
+    batch(1);  // warm caches and page in the data
+    int reps = 1;
+    while (batch(reps) < settings.min_time && reps < (1 << 24)) reps *= 2;
+
+    double best = std::numeric_limits<double>::max();
+    for (int i = 0; i < 5; ++i) best = std::min(best, batch(reps) / reps);
+    return best;
+}
+
+void Report(const char* kernel, int64_t elements, double bytes_per_element, double seconds,
+            double energy = -1) {
+    const double ns = seconds * 1e9 / elements;
+    if (bytes_per_element > 0) {
+        std::printf("%-24s %10lld %10.2f %8.0f %8.2f", kernel, (long long)elements, ns,
+                    bytes_per_element, bytes_per_element / ns);
+    } else {
+        std::printf("%-24s %10lld %10.2f %8s %8s", kernel, (long long)elements, ns, "-", "-");
+    }
+    if (energy >= 0) std::printf(" %12.6g", energy);
+    std::printf("\n");
+    std::fflush(stdout);
+}
+
+bool Selected(const Settings& settings, const char* kernel) {
+    return !settings.filter || std::strstr(kernel, settings.filter);
+}
+
+// ---------------------------------------------------------------------------
+// Synthetic surface: a side x side grid on a paraboloid patch, spacing 1,
+// 4-neighbour adjacency with unit weights.
+// ---------------------------------------------------------------------------
+struct Surface {
+    int side = 0;
+    MatrixXd V, N, Q, O, S;
+    VectorXd A;
+    AdjacentMatrix adj;
+    double scale = 2.0;   // target edge length in grid units
+    double links_per_vertex = 0;
+};
+
+Surface MakeSurface(int side, uint64_t seed) {
+    const int n = side * side;
+    const double curvature = 1.0 / side;
+    Surface s;
+    s.side = side;
+    s.V.resize(3, n);
+    s.N.resize(3, n);
+    s.Q.resize(3, n);
+    s.O.resize(3, n);
+    s.S = MatrixXd::Ones(2, n);
+    s.A = VectorXd::Ones(n);
+    s.adj.resize(n);
+
+    pcg32 rng;
+    rng.seed(seed);
+    int64_t links = 0;
+    for (int y = 0; y < side; ++y) {
+        for (int x = 0; x < side; ++x) {
+            const int i = y * side + x;
+            const double px = x - 0.5 * side, py = y - 0.5 * side;
+            s.V.col(i) = Vector3d(px, py, 0.5 * curvature * (px * px + py * py));
+            s.N.col(i) = Vector3d(-curvature * px, -curvature * py, 1.0).normalized();
+
+            Vector3d b, c;
+            coordinate_system(s.N.col(i), b, c);
+            const double angle = rng.nextDouble() * 2 * M_PI;
+            s.Q.col(i) = b * std::cos(angle) + c * std::sin(angle);
+            s.O.col(i) = s.V.col(i) + (b * (rng.nextDouble() - 0.5) + c * (rng.nextDouble() - 0.5)) * s.scale;
+
+            if (x > 0)        s.adj[i].emplace_back(i - 1);
+            if (x + 1 < side) s.adj[i].emplace_back(i + 1);
+            if (y > 0)        s.adj[i].emplace_back(i - side);
+            if (y + 1 < side) s.adj[i].emplace_back(i + side);
+            links += (int64_t)s.adj[i].size();
+        }
+    }
+    s.links_per_vertex = (double)links / n;
+    return s;
+}
+
+// Single-level hierarchy over the surface: OptimizeOrientations /
+// OptimizePositions with one iteration then run exactly one sweep over all
+// phases, without prolongation or restriction.
+void MakeSingleLevel(const Surface& s, Hierarchy& mRes) {
+    const int n = (int)s.V.cols();
+    std::vector<std::vector<int>> phases;
+    mRes.generate_graph_coloring_deterministic(s.adj, n, phases);
+
+    mRes.mAdj = {s.adj};
+    mRes.mV = {s.V};
+    mRes.mN = {s.N};
+    mRes.mA = {s.A};
+    mRes.mQ = {s.Q};
+    mRes.mO = {s.O};
+    mRes.mS = {s.S};
+    mRes.mK = {MatrixXd::Zero(2, n)};
+    mRes.mCQ = {MatrixXd::Zero(3, n)};
+    mRes.mCO = {MatrixXd::Zero(3, n)};
+    mRes.mCQw = {VectorXd::Zero(n)};
+    mRes.mCOw = {VectorXd::Zero(n)};
+    mRes.mPhases = {phases};
+    mRes.mToUpper.clear();
+    mRes.mToLower.clear();
+    mRes.mScale = s.scale;
+}
+
+// ---------------------------------------------------------------------------
+// Field-math primitives over flat arrays of random frames
+// ---------------------------------------------------------------------------
+void BenchPrimitives(const Settings& settings, int n) {
+    const int side = (int)std::sqrt((double)n);
+    const Surface s = MakeSurface(side, 1);
+    n = side * side;
+
+    // Neighbour j of element i: the next grid vertex, wrapping around
+    auto next = [n](int i) { return i + 1 < n ? i + 1 : 0; };
+
+    if (Selected(settings, "orientation_extrinsic_4")) {
+        const double seconds = Measure(settings, [&]() {
+            double sum = 0;
+            for (int i = 0; i < n; ++i) {
+                const int j = next(i);
+                auto value = compat_orientation_extrinsic_4(s.Q.col(i), s.N.col(i), s.Q.col(j), s.N.col(j));
+                sum += value.first.x() + value.second.y();
+            }
+            g_sink = sum;
+        });
+        Report("orientation_extrinsic_4", n, 4 * 24 + 2 * 24, seconds);
+    }
+
+    if (Selected(settings, "position_extrinsic_4")) {
+        const double scale = s.scale, inv_scale = 1.0 / scale;
+        const double seconds = Measure(settings, [&]() {
+            double sum = 0;
+            for (int i = 0; i < n; ++i) {
+                const int j = next(i);
+                auto value = compat_position_extrinsic_4(
+                    s.V.col(i), s.N.col(i), s.Q.col(i), s.O.col(i),
+                    s.V.col(j), s.N.col(j), s.Q.col(j), s.O.col(j),
+                    scale, scale, inv_scale, inv_scale, scale, scale, inv_scale, inv_scale);
+                sum += value.first.x() + value.second.y();
+            }
+            g_sink = sum;
+        });
+        Report("position_extrinsic_4", n, 8 * 24 + 2 * 24, seconds);
+    }
+
+    if (Selected(settings, "position_round_4")) {
+        const double scale = s.scale, inv_scale = 1.0 / scale;
+        const double seconds = Measure(settings, [&]() {
+            double sum = 0;
+            for (int i = 0; i < n; ++i) {
+                const Vector3d o = position_round_4(s.O.col(i), s.Q.col(i), s.N.col(i), s.V.col(i),
+                                                    scale, scale, inv_scale, inv_scale);
+                sum += o.x();
+            }
+            g_sink = sum;
+        });
+        Report("position_round_4", n, 4 * 24 + 24, seconds);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// One smoothing sweep over all phases of a level
+// ---------------------------------------------------------------------------
+void BenchSweeps(const Settings& settings, int n) {
+    const int side = (int)std::sqrt((double)n);
+    const Surface s = MakeSurface(side, 2);
+    n = side * side;
+    const double links = s.links_per_vertex;
+    const double link_bytes = 16;   // sizeof(Link)
+    const double row_bytes = 24;    // std::vector header per adjacency row
+
+    SolverSchedule one_sweep;
+    one_sweep.iterations = 1;
+
+    Hierarchy mRes;
+    MakeSingleLevel(s, mRes);
+
+    if (Selected(settings, "orientation_sweep")) {
+        const double seconds = Measure(settings, [&]() {
+            OptimizeOrientations(mRes, one_sweep);
+        }, [&]() { mRes.mQ[0] = s.Q; });
+        // Own N, Q; per link its weight / id and the neighbour's N, Q; Q written
+        Report("orientation_sweep", n, row_bytes + 48 + links * (link_bytes + 48) + 24, seconds);
+    }
+
+    // Uniform scale; the pipeline always takes the `_scaled` path
+    if (Selected(settings, "position_sweep")) {
+        const double seconds = Measure(settings, [&]() {
+            OptimizePositions(mRes, 0, one_sweep);
+        }, [&]() { mRes.mO[0] = s.O; });
+        // Own V, N, Q, O; per link the neighbour's V, N, Q, O; O written
+        Report("position_sweep", n, row_bytes + 96 + links * (link_bytes + 96) + 24, seconds);
+    }
+
+    if (Selected(settings, "position_sweep_scaled")) {
+        const double seconds = Measure(settings, [&]() {
+            OptimizePositions(mRes, 1, one_sweep);
+        }, [&]() { mRes.mO[0] = s.O; });
+        Report("position_sweep_scaled", n, row_bytes + 112 + links * (link_bytes + 112) + 24, seconds);
+    }
+    g_sink = mRes.mQ[0](0, 0) + mRes.mO[0](0, 0);
+}
+
+// ---------------------------------------------------------------------------
+// Domain-decomposed and colored sweeps over 1, 2, 4, ... pool threads.
+// Smaller sizes have too few blocks per thread to say anything about
+// scaling.
+// ---------------------------------------------------------------------------
+void BenchScaling(const Settings& settings, int n) {
+    if (n < (1 << 16)) return;
+    const char* const variants[] = {"domains", "colored"};
+    char name[48];
+    bool any = false;
+    for (const char* variant : variants) {
+        for (const char* field : {"orientation", "position"}) {
+            std::snprintf(name, sizeof(name), "%s_%s/", field, variant);
+            any = any || Selected(settings, name);
+        }
+    }
+    if (!any) return;
+
+    const int side = (int)std::sqrt((double)n);
+    const Surface s = MakeSurface(side, 2);
+    n = side * side;
+    const double links = s.links_per_vertex;
+
+    Hierarchy mRes;
+    MakeSingleLevel(s, mRes);
+
+    for (int threads = 1; threads <= settings.max_threads; threads *= 2) {
+        configure_thread_pool(threads, false);
+        for (const char* variant : variants) {
+            SolverSchedule one_sweep;
+            one_sweep.iterations = 1;
+            one_sweep.domain_decomposition = std::strcmp(variant, "domains") == 0;
+
+            std::snprintf(name, sizeof(name), "orientation_%s/%d", variant, threads);
+            if (Selected(settings, name)) {
+                const double seconds = Measure(settings, [&]() {
+                    OptimizeOrientations(mRes, one_sweep);
+                }, [&]() { mRes.mQ[0] = s.Q; });
+                Report(name, n, 24 + 48 + links * (16 + 48) + 24, seconds);
+            }
+            std::snprintf(name, sizeof(name), "position_%s/%d", variant, threads);
+            if (Selected(settings, name)) {
+                const double seconds = Measure(settings, [&]() {
+                    OptimizePositions(mRes, 0, one_sweep);
+                }, [&]() { mRes.mO[0] = s.O; });
+                Report(name, n, 24 + 96 + links * (16 + 96) + 24, seconds);
+            }
+        }
+    }
+    configure_thread_pool(0, false);
+    g_sink = mRes.mQ[0](0, 0) + mRes.mO[0](0, 0);
+}
+
+// ---------------------------------------------------------------------------
+// Chaotic relaxation against the colored sweeps: time per sweep of a full
+// solve and the energy it converges to
+// ---------------------------------------------------------------------------
+double OrientationEnergy(const Surface& s, const MatrixXd& Q) {
+    double energy = 0, weights = 0;
+    for (int i = 0; i < (int)s.adj.size(); ++i) {
+        for (const auto& link : s.adj[i]) {
+            const auto value = compat_orientation_extrinsic_4(
+                Q.col(i), s.N.col(i), Q.col(link.id), s.N.col(link.id));
+            energy += link.weight * (value.first - value.second).squaredNorm();
+            weights += link.weight;
+        }
+    }
+    return weights > 0 ? energy / weights : 0;
+}
+
+double PositionEnergy(const Surface& s, const MatrixXd& Q, const MatrixXd& O) {
+    const double scale = s.scale, inv_scale = 1.0 / scale;
+    double energy = 0, weights = 0;
+    for (int i = 0; i < (int)s.adj.size(); ++i) {
+        for (const auto& link : s.adj[i]) {
+            const int j = link.id;
+            const auto value = compat_position_extrinsic_4(
+                s.V.col(i), s.N.col(i), Q.col(i), O.col(i), s.V.col(j), s.N.col(j), Q.col(j), O.col(j),
+                scale, scale, inv_scale, inv_scale, scale, scale, inv_scale, inv_scale);
+            energy += link.weight * (value.first - value.second).squaredNorm() * inv_scale * inv_scale;
+            weights += link.weight;
+        }
+    }
+    return weights > 0 ? energy / weights : 0;
+}
+
+void BenchRelaxation(const Settings& settings, int n) {
+    if (n < (1 << 16)) return;
+    const int side = (int)std::sqrt((double)n);
+    const Surface s = MakeSurface(side, 5);
+    n = side * side;
+    const double links = s.links_per_vertex;
+
+    Hierarchy mRes;
+    MakeSingleLevel(s, mRes);
+    for (const bool chaotic : {false, true}) {
+        SolverSchedule solve;
+        solve.chaotic_relaxation = chaotic;
+        const double sweeps = solve.iterations;
+
+        const char* name = chaotic ? "orientation_chaotic" : "orientation_colored";
+        if (Selected(settings, name)) {
+            auto reset = [&]() { mRes.mQ[0] = s.Q; };
+            auto run = [&]() { OptimizeOrientations(mRes, solve); };
+            const double seconds = Measure(settings, run, reset);
+            reset();
+            run();
+            Report(name, n, 24 + 48 + links * (16 + 48) + 24, seconds / sweeps,
+                   OrientationEnergy(s, mRes.mQ[0]));
+        }
+
+        // Positions against the orientation field the colored solve settles on
+        name = chaotic ? "position_chaotic" : "position_colored";
+        if (Selected(settings, name)) {
+            mRes.mQ[0] = s.Q;
+            OptimizeOrientations(mRes, SolverSchedule());
+            auto reset = [&]() { mRes.mO[0] = s.O; };
+            auto run = [&]() { OptimizePositions(mRes, 0, solve); };
+            const double seconds = Measure(settings, run, reset);
+            reset();
+            run();
+            Report(name, n, 24 + 96 + links * (16 + 96) + 24, seconds / sweeps,
+                   PositionEnergy(s, mRes.mQ[0], mRes.mO[0]));
+        }
+    }
+    g_sink = mRes.mQ[0](0, 0) + mRes.mO[0](0, 0);
+}
+
+// ---------------------------------------------------------------------------
+// Session previews of the surface, triangulated: the first call (load and
+// hierarchy build included) and a slider move to another target on the
+// warm session. Elements are input triangles, so at 2^20 triangles
+// 95 ns/elem is 100 ms per call.
+// ---------------------------------------------------------------------------
+void BenchPreview(const Settings& settings, int n) {
+    const bool cold = Selected(settings, "preview_cold");
+    const bool warm = Selected(settings, "preview_warm");
+    if (n < (1 << 14) || (!cold && !warm)) return;
+    const int side = (int)std::sqrt((double)n / 2) + 1;
+    const Surface s = MakeSurface(side, 6);
+    std::vector<double> vertices(s.V.data(), s.V.data() + s.V.size());
+    std::vector<int> faces;
+    faces.reserve((size_t)(side - 1) * (side - 1) * 6);
+    for (int y = 0; y + 1 < side; ++y) {
+        for (int x = 0; x + 1 < side; ++x) {
+            const int a = y * side + x, b = a + 1, c = a + side + 1, d = a + side;
+            faces.insert(faces.end(), {a, b, c, a, c, d});
+        }
+    }
+    const int64_t triangles = (int64_t)faces.size() / 3;
+    const int target = std::max(100, (int)(triangles / 100));
+
+    QuadriFlowOptions options;
+    std::unique_ptr<QuadriFlowSession> session;
+    auto open = [&]() {
+        session.reset(new QuadriFlowSession(vertices.data(), (int64_t)vertices.size() / 3,
+                                            faces.data(), triangles, options));
+    };
+    if (cold) {
+        const double seconds = Measure(settings, [&]() {
+            g_sink = (double)session->preview(target).num_faces;
+        }, open);
+        Report("preview_cold", triangles, 0, seconds);
+    }
+    if (warm) {
+        open();
+        session->preview(target);
+        int step = 0;
+        const double seconds = Measure(settings, [&]() {
+            // Alternate targets, as a slider would
+            g_sink = (double)session->preview(++step % 2 ? target / 2 : target).num_faces;
+        });
+        Report("preview_warm", triangles, 0, seconds);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Random neighbour gathers, as the sweeps do on a badly ordered mesh, from a
+// 3 x n field on default pages and on huge pages. The gap is the TLB cost.
+// ---------------------------------------------------------------------------
+void BenchGather(const Settings& settings, int n) {
+    pcg32 rng;
+    std::vector<int> ids(n);
+    for (int& id : ids) id = (int)rng.nextUInt(n);
+
+    auto gather = [&](const double* field) {
+        double sum = 0;
+        for (int id : ids) {
+            const double* q = field + (size_t)id * 3;
+            sum += q[0] + q[1] + q[2];
+        }
+        g_sink = sum;
+    };
+
+    if (Selected(settings, "gather")) {
+        std::vector<double> field((size_t)n * 3, 1.0);
+        const double seconds = Measure(settings, [&]() { gather(field.data()); });
+        Report("gather", n, 4 + 24, seconds);
+    }
+
+    if (Selected(settings, "gather_hugepages")) {
+        HugePageVector<double> field((size_t)n * 3, 1.0);
+        const double seconds = Measure(settings, [&]() { gather(field.data()); });
+        Report("gather_hugepages", n, 4 + 24, seconds);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Hierarchy construction: one DownsampleGraph step
+// ---------------------------------------------------------------------------
+void BenchDownsample(const Settings& settings, int n) {
+    if (!Selected(settings, "downsample_graph")) return;
+    const int side = (int)std::sqrt((double)n);
+    const Surface s = MakeSurface(side, 3);
+    n = side * side;
+
+    Hierarchy mRes;
+    MatrixXd V_p, N_p;
+    VectorXd A_p;
+    MatrixXi to_upper;
+    VectorXi to_lower;
+    AdjacentMatrix adj_p;
+    const double seconds = Measure(settings, [&]() {
+        mRes.DownsampleGraph(s.adj, s.V, s.N, s.A, V_p, N_p, A_p, to_upper, to_lower, adj_p);
+    });
+    g_sink = (double)V_p.cols();
+    // V, N, A and the adjacency read; roughly half the vertices written back
+    Report("downsample_graph", n, 24 + 56 + s.links_per_vertex * 16 + 0.5 * (56 + 8 + 4 + 24), seconds);
+}
+
+// ---------------------------------------------------------------------------
+// Integer constraint flow: a grid network with random capacities, supplies
+// from the source and demands to the sink, as built by
+// Optimizer::optimize_integer_constraints (source 0, sink n + 1).
+// Timed from construction, since a helper solves only once.
+// ---------------------------------------------------------------------------
+void BenchFlow(const Settings& settings, int n) {
+    const int side = (int)std::sqrt((double)n);
+    n = side * side;
+
+    struct Arc {
+        int x, y, c, rc;
+    };
+    std::vector<Arc> arcs;
+    pcg32 rng;
+    rng.seed(4);
+    for (int y = 0; y < side; ++y) {
+        for (int x = 0; x < side; ++x) {
+            const int i = 1 + y * side + x;
+            if (x + 1 < side) arcs.push_back({i, i + 1, 1 + (int)rng.nextUInt(4), 1 + (int)rng.nextUInt(4)});
+            if (y + 1 < side) arcs.push_back({i, i + side, 1 + (int)rng.nextUInt(4), 1 + (int)rng.nextUInt(4)});
+            const int supply = (int)rng.nextUInt(5) - 2;
+            if (supply > 0) arcs.push_back({0, i, supply, 0});
+            if (supply < 0) arcs.push_back({i, n + 1, -supply, 0});
+        }
+    }
+
+    auto solve = [&](MaxFlowHelper& helper) {
+        helper.resize(n + 2, (int)arcs.size());
+        for (size_t e = 0; e < arcs.size(); ++e) {
+            helper.addEdge(arcs[e].x, arcs[e].y, arcs[e].c, arcs[e].rc, (int)e);
+        }
+        g_sink = helper.compute();
+    };
+
+    if (Selected(settings, "flow_boykov")) {
+        const double seconds = Measure(settings, [&]() {
+            BoykovMaxFlowHelper helper;
+            solve(helper);
+        });
+        Report("flow_boykov", n, 0, seconds);
+    }
+
+    // Network simplex is superlinear; keep it to the smaller sizes
+    if (Selected(settings, "flow_network_simplex") && n <= (1 << 16)) {
+        const double seconds = Measure(settings, [&]() {
+            NetworkSimplexFlowHelper helper;
+            solve(helper);
+        });
+        Report("flow_network_simplex", n, 0, seconds);
+    }
+}
+
+[[noreturn]] void Usage(const char* program) {
+    std::fprintf(stderr,
+                 "usage: %s [filter] [--max-size N] [--min-time SECONDS] [--max-threads N]\n",
+                 program);
+    std::exit(2);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Settings settings;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--max-size") && i + 1 < argc) {
+            settings.max_size = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--min-time") && i + 1 < argc) {
+            settings.min_time = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--max-threads") && i + 1 < argc) {
+            settings.max_threads = std::atoi(argv[++i]);
+        } else if (argv[i][0] != '-' && !settings.filter) {
+            settings.filter = argv[i];
+        } else {
+            Usage(argv[0]);
+        }
+    }
+    if (settings.max_size < 1024 || settings.min_time <= 0 || settings.max_threads < 1) {
+        Usage(argv[0]);
+    }
+
+    std::printf("%-24s %10s %10s %8s %8s %12s\n", "kernel", "elements", "ns/elem", "bytes", "GB/s",
+                "energy");
+    for (int n = 1 << 10; n <= settings.max_size; n *= 4) {
+        BenchPrimitives(settings, n);
+        BenchSweeps(settings, n);
+        BenchScaling(settings, n);
+        BenchRelaxation(settings, n);
+        BenchPreview(settings, n);
+        BenchGather(settings, n);
+        BenchDownsample(settings, n);
+        BenchFlow(settings, n);
+    }
+    return 0;
+}
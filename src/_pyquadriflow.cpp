@@ -5,6 +5,8 @@
 
 #include <nanobind/nanobind.h>
 #include <nanobind/ndarray.h>
+#include <nanobind/stl/string.h>
+#include <nanobind/stl/vector.h>
 #include <cstring>
 
 #include "array_support.h"
@@ -12,6 +14,162 @@
 
 namespace nb = nanobind;
 
+static const struct {
+    unsigned bit;
+    const char* name;
+} kDegradationNames[] = {
+    {DEGRADE_SKIP_MINIMUM_COST_FLOW, "skip_minimum_cost_flow"},
+    {DEGRADE_SKIP_AGGRESSIVE_SAT, "skip_aggressive_sat"},
+    {DEGRADE_FEWER_ITERATIONS, "fewer_iterations"},
+    {DEGRADE_COARSE_LEVELS_ONLY, "coarse_levels_only"},
+};
+
+static nb::dict MakeStats(const QuadriFlowResult& result) {
+    nb::dict stages;
+    double total = 0;
+    for (const auto& stage : result.stages) {
+        stages[stage.name.c_str()] = stage.seconds;
+        total += stage.seconds;
+    }
+
+    nb::list degradations;
+    for (const auto& d : kDegradationNames) {
+        if (result.degradations & d.bit) degradations.append(d.name);
+    }
+
+    nb::dict stats;
+    stats["stages"] = stages;
+    if (allocation_accounting_available()) {
+        nb::dict allocations;
+        for (const auto& stage : result.stages) {
+            nb::dict counts;
+            counts["allocations"] = stage.allocations;
+            counts["frees"] = stage.frees;
+            counts["bytes_allocated"] = stage.bytes_allocated;
+            counts["peak_bytes"] = stage.peak_bytes;
+            allocations[stage.name.c_str()] = counts;
+        }
+        stats["allocations"] = allocations;
+    }
+    nb::dict counters;
+    const double elements = result.working_vertices > 0 ? result.working_vertices : 1;
+    for (const auto& stage : result.stages) {
+        if (stage.cycles < 0) continue;
+        nb::dict counts;
+        counts["cycles"] = stage.cycles;
+        if (stage.instructions >= 0) {
+            counts["instructions"] = stage.instructions;
+            counts["ipc"] = stage.cycles > 0 ? (double)stage.instructions / stage.cycles : 0.0;
+        }
+        if (stage.llc_misses >= 0) {
+            counts["llc_misses"] = stage.llc_misses;
+            counts["llc_misses_per_element"] = stage.llc_misses / elements;
+        }
+        if (stage.branch_misses >= 0) {
+            counts["branch_misses"] = stage.branch_misses;
+            counts["branch_misses_per_element"] = stage.branch_misses / elements;
+        }
+        if (stage.dtlb_misses >= 0) {
+            counts["dtlb_misses"] = stage.dtlb_misses;
+            counts["dtlb_misses_per_element"] = stage.dtlb_misses / elements;
+        }
+        counters[stage.name.c_str()] = counts;
+    }
+    if (nb::len(counters) > 0) stats["counters"] = counters;
+    stats["total_seconds"] = total;
+    stats["degradations"] = degradations;
+    stats["seed"] = result.seed;
+    if (result.num_singularities >= 0) {
+        stats["singularities"] = result.num_singularities;
+    }
+    if (result.numa_node >= 0) {
+        stats["numa_node"] = result.numa_node;
+    }
+    if (result.working_vertices > 0) {
+        stats["working_vertices"] = result.working_vertices;
+    }
+    if (!result.phase_sizes.empty()) {
+        nb::list levels;
+        for (const auto& level : result.phase_sizes) {
+            nb::list sizes;
+            for (int64_t size : level) sizes.append(size);
+            levels.append(sizes);
+        }
+        stats["phase_sizes"] = levels;
+    }
+    return stats;
+}
+
+static void CheckInputShapes(
+    const NDArray<const double, 2>& vertices,
+    const NDArray<const int, 2>& faces
+) {
+    if (vertices.shape(1) != 3) {
+        throw std::runtime_error("vertices must have shape (N, 3)");
+    }
+    if (faces.shape(1) != 3) {
+        throw std::runtime_error("faces must have shape (M, 3) — input must be a triangle mesh");
+    }
+    if (vertices.shape(0) == 0 || faces.shape(0) == 0) {
+        throw std::runtime_error("Input mesh is empty");
+    }
+}
+
+static QuadriFlowOptions MakeOptions(
+    int target_faces,
+    int seed,
+    bool preserve_sharp,
+    bool preserve_boundary,
+    bool adaptive_scale,
+    bool aggressive_sat,
+    bool minimum_cost_flow,
+    double time_budget_ms,
+    bool reorder_output
+) {
+    QuadriFlowOptions options;
+    options.target_faces = target_faces;
+    options.seed = seed;
+    options.preserve_sharp = preserve_sharp;
+    options.preserve_boundary = preserve_boundary;
+    options.adaptive_scale = adaptive_scale;
+    options.aggressive_sat = aggressive_sat;
+    options.minimum_cost_flow = minimum_cost_flow;
+    options.time_budget_ms = time_budget_ms;
+    options.reorder_output = reorder_output;
+    return options;
+}
+
+static NDArray<double, 2> MakeVerticesArray(const QuadriFlowResult& result) {
+    NDArray<double, 2> verts_arr = MakeNDArray<double, 2>(
+        {static_cast<size_t>(result.num_vertices), 3});
+    std::memcpy(verts_arr.data(), result.vertices.data(),
+        result.vertices.size() * sizeof(double));
+    return verts_arr;
+}
+
+static NDArray<int, 2> MakeFacesArray(const QuadriFlowResult& result) {
+    NDArray<int, 2> faces_arr = MakeNDArray<int, 2>(
+        {static_cast<size_t>(result.num_faces), 4});
+    std::memcpy(faces_arr.data(), result.faces.data(),
+        result.faces.size() * sizeof(int));
+    return faces_arr;
+}
+
+// (vertices, faces, stats) as returned by every remeshing entry point, or
+// (encoded bytes, None, stats) when the pipeline encoded the result
+static nb::tuple MakeResultTuple(const QuadriFlowResult& result) {
+    if (!result.encoded.empty()) {
+        nb::bytes encoded(reinterpret_cast<const char*>(result.encoded.data()),
+                          result.encoded.size());
+        return nb::make_tuple(encoded, nb::none(), MakeStats(result));
+    }
+    return nb::make_tuple(MakeVerticesArray(result), MakeFacesArray(result),
+                          MakeStats(result));
+}
+
+// The entry points below release the GIL while the pipeline runs: it only
+// reads the borrowed input buffers, which the arguments keep alive, and the
+// Python results are built after the GIL is reacquired.
 static nb::tuple py_quadriflow_remesh(
     const NDArray<const double, 2> vertices,
     const NDArray<const int, 2> faces,
@@ -21,38 +179,423 @@ static nb::tuple py_quadriflow_remesh(
     bool preserve_boundary,
     bool adaptive_scale,
     bool aggressive_sat,
-    bool minimum_cost_flow
+    bool minimum_cost_flow,
+    double time_budget_ms,
+    bool reorder_output,
+    int encode_position_bits,
+    bool domain_decomposition,
+    bool balanced_coloring,
+    bool chaotic_relaxation
+) {
+    CheckInputShapes(vertices, faces);
+
+    QuadriFlowOptions options = MakeOptions(
+        target_faces, seed, preserve_sharp, preserve_boundary,
+        adaptive_scale, aggressive_sat, minimum_cost_flow,
+        time_budget_ms, reorder_output);
+    options.encode_position_bits = encode_position_bits;
+    options.domain_decomposition = domain_decomposition;
+    options.balanced_coloring = balanced_coloring;
+    options.chaotic_relaxation = chaotic_relaxation;
+
+    QuadriFlowResult result;
+    {
+        nb::gil_scoped_release release;
+        result = run_quadriflow(
+            vertices.data(), static_cast<int64_t>(vertices.shape(0)),
+            faces.data(), static_cast<int64_t>(faces.shape(0)),
+            options
+        );
+    }
+
+    return MakeResultTuple(result);
+}
+
+static nb::tuple py_quadriflow_remesh_roi(
+    const NDArray<const double, 2> vertices,
+    const NDArray<const int, 2> faces,
+    const NDArray<const uint8_t, 1> face_mask,
+    int target_faces,
+    int seed,
+    bool preserve_sharp,
+    bool adaptive_scale,
+    bool aggressive_sat,
+    bool minimum_cost_flow,
+    double time_budget_ms,
+    bool reorder_output,
+    bool domain_decomposition,
+    bool balanced_coloring
+) {
+    CheckInputShapes(vertices, faces);
+    if (face_mask.shape(0) != faces.shape(0)) {
+        throw std::runtime_error("face_mask must have one entry per face");
+    }
+
+    QuadriFlowOptions options = MakeOptions(
+        target_faces, seed, preserve_sharp, true,
+        adaptive_scale, aggressive_sat, minimum_cost_flow,
+        time_budget_ms, reorder_output);
+    options.domain_decomposition = domain_decomposition;
+    options.balanced_coloring = balanced_coloring;
+
+    QuadriFlowResult result;
+    {
+        nb::gil_scoped_release release;
+        result = run_quadriflow_roi(
+            vertices.data(), static_cast<int64_t>(vertices.shape(0)),
+            faces.data(), static_cast<int64_t>(faces.shape(0)),
+            face_mask.data(), options
+        );
+    }
+
+    NDArray<int, 2> tris_arr = MakeNDArray<int, 2>(
+        {static_cast<size_t>(result.num_triangles), 3});
+    std::memcpy(tris_arr.data(), result.triangles.data(),
+        result.triangles.size() * sizeof(int));
+
+    return nb::make_tuple(MakeVerticesArray(result), MakeFacesArray(result),
+                          tris_arr, MakeStats(result));
+}
+
+static nb::list py_quadriflow_remesh_seeds(
+    const NDArray<const double, 2> vertices,
+    const NDArray<const int, 2> faces,
+    int target_faces,
+    std::vector<int> seeds,
+    bool return_all,
+    bool preserve_sharp,
+    bool preserve_boundary,
+    bool adaptive_scale,
+    bool aggressive_sat,
+    bool minimum_cost_flow,
+    double time_budget_ms,
+    bool reorder_output,
+    int encode_position_bits
+) {
+    CheckInputShapes(vertices, faces);
+
+    QuadriFlowOptions options = MakeOptions(
+        target_faces, 0, preserve_sharp, preserve_boundary,
+        adaptive_scale, aggressive_sat, minimum_cost_flow,
+        time_budget_ms, reorder_output);
+    options.encode_position_bits = encode_position_bits;
+
+    std::vector<QuadriFlowResult> results;
+    {
+        nb::gil_scoped_release release;
+        results = run_quadriflow_seeds(
+            vertices.data(), static_cast<int64_t>(vertices.shape(0)),
+            faces.data(), static_cast<int64_t>(faces.shape(0)),
+            options, seeds, return_all
+        );
+    }
+
+    nb::list out;
+    for (const auto& result : results) {
+        out.append(MakeResultTuple(result));
+    }
+    return out;
+}
+
+static nb::list py_quadriflow_remesh_batch(
+    const std::vector<NDArray<const double, 2>>& vertices,
+    const std::vector<NDArray<const int, 2>>& faces,
+    int target_faces,
+    int max_workers,
+    int seed,
+    bool preserve_sharp,
+    bool preserve_boundary,
+    bool adaptive_scale,
+    bool aggressive_sat,
+    bool minimum_cost_flow,
+    double time_budget_ms,
+    bool reorder_output,
+    int encode_position_bits
+) {
+    if (vertices.size() != faces.size()) {
+        throw std::runtime_error("vertices and faces must hold the same number of meshes");
+    }
+    std::vector<QuadriFlowMeshInput> meshes(vertices.size());
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        CheckInputShapes(vertices[i], faces[i]);
+        meshes[i] = {vertices[i].data(), static_cast<int64_t>(vertices[i].shape(0)),
+                     faces[i].data(), static_cast<int64_t>(faces[i].shape(0))};
+    }
+
+    QuadriFlowOptions options = MakeOptions(
+        target_faces, seed, preserve_sharp, preserve_boundary,
+        adaptive_scale, aggressive_sat, minimum_cost_flow,
+        time_budget_ms, reorder_output);
+    options.encode_position_bits = encode_position_bits;
+
+    std::vector<QuadriFlowResult> results;
+    {
+        nb::gil_scoped_release release;
+        results = run_quadriflow_batch(meshes, options, max_workers);
+    }
+
+    nb::list out;
+    for (const auto& result : results) {
+        out.append(MakeResultTuple(result));
+    }
+    return out;
+}
+
+static nb::bytes py_encode_mesh(
+    const NDArray<const double, 2> vertices,
+    const NDArray<const int, 2> faces,
+    int position_bits
 ) {
     if (vertices.shape(1) != 3) {
         throw std::runtime_error("vertices must have shape (N, 3)");
     }
-    if (faces.shape(1) != 3) {
-        throw std::runtime_error("faces must have shape (M, 3) — input must be a triangle mesh");
+    if (faces.shape(1) != 4) {
+        throw std::runtime_error("faces must have shape (M, 4)");
     }
-    if (vertices.shape(0) == 0 || faces.shape(0) == 0) {
-        throw std::runtime_error("Input mesh is empty");
+
+    std::vector<unsigned char> encoded;
+    {
+        nb::gil_scoped_release release;
+        QuadriFlowResult mesh;
+        mesh.num_vertices = static_cast<int64_t>(vertices.shape(0));
+        mesh.num_faces = static_cast<int64_t>(faces.shape(0));
+        mesh.vertices.assign(vertices.data(), vertices.data() + vertices.size());
+        mesh.faces.assign(faces.data(), faces.data() + faces.size());
+        encoded = encode_quadriflow_result(mesh, position_bits);
     }
+    return nb::bytes(reinterpret_cast<const char*>(encoded.data()), encoded.size());
+}
+
+static nb::tuple py_decode_mesh(const NDArray<const uint8_t, 1> data) {
+    QuadriFlowResult mesh;
+    {
+        nb::gil_scoped_release release;
+        mesh = decode_quadriflow_result(data.data(), data.shape(0));
+    }
+    return nb::make_tuple(MakeVerticesArray(mesh), MakeFacesArray(mesh));
+}
+
+static void py_remesher_init(
+    QuadriFlowSession* self,
+    const NDArray<const double, 2> vertices,
+    const NDArray<const int, 2> faces,
+    int seed,
+    bool preserve_sharp,
+    bool preserve_boundary,
+    bool adaptive_scale,
+    bool aggressive_sat,
+    bool minimum_cost_flow,
+    double time_budget_ms,
+    bool reorder_output,
+    bool domain_decomposition,
+    bool balanced_coloring,
+    bool chaotic_relaxation
+) {
+    CheckInputShapes(vertices, faces);
 
-    QuadriFlowResult result = run_quadriflow(
-        vertices.data(), static_cast<int>(vertices.shape(0)),
-        faces.data(), static_cast<int>(faces.shape(0)),
-        target_faces, seed,
-        preserve_sharp, preserve_boundary,
-        adaptive_scale, aggressive_sat, minimum_cost_flow
+    QuadriFlowOptions options = MakeOptions(
+        0, seed, preserve_sharp, preserve_boundary,
+        adaptive_scale, aggressive_sat, minimum_cost_flow,
+        time_budget_ms, reorder_output);
+    options.domain_decomposition = domain_decomposition;
+    options.balanced_coloring = balanced_coloring;
+    options.chaotic_relaxation = chaotic_relaxation;
+
+    nb::gil_scoped_release release;
+    new (self) QuadriFlowSession(
+        vertices.data(), static_cast<int64_t>(vertices.shape(0)),
+        faces.data(), static_cast<int64_t>(faces.shape(0)),
+        options
     );
+}
 
-    // Convert result to numpy arrays
-    NDArray<double, 2> verts_arr = MakeNDArray<double, 2>(
-        {result.num_vertices, 3});
-    std::memcpy(verts_arr.data(), result.vertices.data(),
-        result.num_vertices * 3 * sizeof(double));
+static void py_mesh_builder_add_chunk(
+    QuadriFlowMeshBuilder& self,
+    const NDArray<const double, 2> vertices,
+    const NDArray<const int, 2> faces
+) {
+    CheckInputShapes(vertices, faces);
 
-    NDArray<int, 2> faces_arr = MakeNDArray<int, 2>(
-        {result.num_faces, 4});
-    std::memcpy(faces_arr.data(), result.faces.data(),
-        result.num_faces * 4 * sizeof(int));
+    nb::gil_scoped_release release;
+    self.add_chunk(
+        vertices.data(), static_cast<int64_t>(vertices.shape(0)),
+        faces.data(), static_cast<int64_t>(faces.shape(0))
+    );
+}
+
+static nb::tuple py_mesh_builder_remesh(
+    QuadriFlowMeshBuilder& self,
+    int target_faces,
+    int seed,
+    bool preserve_sharp,
+    bool preserve_boundary,
+    bool adaptive_scale,
+    bool aggressive_sat,
+    bool minimum_cost_flow,
+    double time_budget_ms,
+    bool reorder_output,
+    bool domain_decomposition,
+    bool balanced_coloring
+) {
+    QuadriFlowOptions options = MakeOptions(
+        target_faces, seed, preserve_sharp, preserve_boundary,
+        adaptive_scale, aggressive_sat, minimum_cost_flow,
+        time_budget_ms, reorder_output);
+    options.domain_decomposition = domain_decomposition;
+    options.balanced_coloring = balanced_coloring;
+
+    QuadriFlowResult result;
+    {
+        nb::gil_scoped_release release;
+        result = self.remesh(options);
+    }
+
+    return MakeResultTuple(result);
+}
+
+// (n, rows) read-only NumPy view over a column-major rows x n field; the
+// capsule shares ownership of the solver state with the session.
+static nb::ndarray<nb::numpy, const double, nb::ndim<2>, nb::c_contig> py_remesher_field(
+    const QuadriFlowSession& self, const std::string& name, int level
+) {
+    QuadriFlowFieldView view = self.field(name, level);
+
+    auto* owner = new std::shared_ptr<const void>(std::move(view.owner));
+    nb::capsule capsule(owner, [](void* p) noexcept {
+        delete static_cast<std::shared_ptr<const void>*>(p);
+    });
+
+    size_t shape[2] = {static_cast<size_t>(view.cols), static_cast<size_t>(view.rows)};
+    return nb::ndarray<nb::numpy, const double, nb::ndim<2>, nb::c_contig>(
+        view.data, 2, shape, capsule);
+}
+
+// (scalars, [(name, dtype, rows, cols, bytes view), ...]); the views are
+// read-only uint8 arrays aliasing the session's storage
+static nb::tuple py_remesher_save_state(const QuadriFlowSession& self) {
+    QuadriFlowSessionState state = self.save_state();
+
+    nb::dict scalars;
+    for (const auto& scalar : state.scalars) scalars[scalar.first.c_str()] = scalar.second;
+
+    nb::list arrays;
+    for (auto& array : state.arrays) {
+        const size_t item = array.dtype == 'f' || array.dtype == 'q' ? 8 : 4;
+        size_t shape[1] = {static_cast<size_t>(array.rows * array.cols) * item};
+        auto* owner = new std::shared_ptr<const void>(std::move(array.owner));
+        nb::capsule capsule(owner, [](void* p) noexcept {
+            delete static_cast<std::shared_ptr<const void>*>(p);
+        });
+        nb::ndarray<nb::numpy, const uint8_t, nb::ndim<1>, nb::c_contig> bytes(
+            array.data, 1, shape, capsule);
+        arrays.append(nb::make_tuple(array.name, std::string(1, array.dtype),
+                                     array.rows, array.cols, bytes));
+    }
+    return nb::make_tuple(scalars, arrays);
+}
+
+static QuadriFlowSession* py_remesher_from_state(const nb::dict& scalars, const nb::list& arrays) {
+    QuadriFlowSessionState state;
+    for (auto item : scalars) {
+        state.scalars.emplace_back(nb::cast<std::string>(item.first),
+                                   nb::cast<double>(item.second));
+    }
+    for (auto entry : arrays) {
+        nb::tuple t = nb::cast<nb::tuple>(entry);
+        QuadriFlowStateArray array;
+        array.name = nb::cast<std::string>(t[0]);
+        const std::string dtype = nb::cast<std::string>(t[1]);
+        array.dtype = dtype.size() == 1 ? dtype[0] : '?';
+        array.rows = nb::cast<int64_t>(t[2]);
+        array.cols = nb::cast<int64_t>(t[3]);
+        auto bytes = nb::cast<nb::ndarray<const uint8_t, nb::ndim<1>, nb::c_contig>>(t[4]);
+        const size_t item = array.dtype == 'f' || array.dtype == 'q' ? 8 : 4;
+        if (array.rows < 0 || array.cols < 0 ||
+            bytes.shape(0) != static_cast<size_t>(array.rows * array.cols) * item) {
+            throw std::runtime_error("Session state array '" + array.name + "' has the wrong size");
+        }
+        array.data = bytes.data();  // borrowed for the call; copied by the session
+        state.arrays.push_back(std::move(array));
+    }
+    nb::gil_scoped_release release;
+    return new QuadriFlowSession(state);
+}
+
+static nb::dict py_get_metrics() {
+    const QuadriFlowMetrics m = get_metrics();
+    nb::dict stages;
+    for (const auto& stage : m.stages) {
+        nb::list buckets;
+        for (size_t i = 0; i < m.bucket_bounds.size(); ++i) {
+            buckets.append(nb::make_tuple(m.bucket_bounds[i], stage.buckets[i]));
+        }
+        nb::dict entry;
+        entry["count"] = stage.count;
+        entry["total_seconds"] = stage.total_seconds;
+        entry["buckets"] = buckets;
+        stages[stage.name.c_str()] = entry;
+    }
+
+    nb::dict out;
+    out["calls"] = m.calls;
+    out["failures"] = m.failures;
+    out["input_faces"] = m.input_faces;
+    out["output_faces"] = m.output_faces;
+    out["peak_memory_bytes"] = m.peak_memory_bytes;
+    out["stages"] = stages;
+    return out;
+}
+
+static nb::dict py_estimate_resources(
+    const NDArray<const double, 2> vertices,
+    const NDArray<const int, 2> faces,
+    int target_faces,
+    bool preserve_sharp,
+    bool preserve_boundary,
+    bool adaptive_scale,
+    bool aggressive_sat,
+    bool minimum_cost_flow,
+    nb::dict cost_model
+) {
+    CheckInputShapes(vertices, faces);
+
+    QuadriFlowOptions options = MakeOptions(
+        target_faces, 0, preserve_sharp, preserve_boundary,
+        adaptive_scale, aggressive_sat, minimum_cost_flow, 0.0, false);
+
+    QuadriFlowCostModel model;
+#define READ_COEFFICIENT(name) \
+    if (cost_model.contains(#name)) model.name = nb::cast<double>(cost_model[#name]);
+    READ_COEFFICIENT(base_bytes)
+    READ_COEFFICIENT(bytes_per_input_face)
+    READ_COEFFICIENT(bytes_per_working_vertex)
+    READ_COEFFICIENT(base_seconds)
+    READ_COEFFICIENT(seconds_per_working_face)
+    READ_COEFFICIENT(seconds_per_output_face)
+    READ_COEFFICIENT(seconds_per_boundary_edge)
+    READ_COEFFICIENT(seconds_per_component)
+    READ_COEFFICIENT(adaptive_scale_factor)
+    READ_COEFFICIENT(preserve_sharp_factor)
+    READ_COEFFICIENT(aggressive_sat_factor)
+    READ_COEFFICIENT(minimum_cost_flow_factor)
+#undef READ_COEFFICIENT
 
-    return nb::make_tuple(verts_arr, faces_arr);
+    QuadriFlowResourceEstimate est = estimate_resources(
+        vertices.data(), static_cast<int64_t>(vertices.shape(0)),
+        faces.data(), static_cast<int64_t>(faces.shape(0)),
+        options, model
+    );
+
+    nb::dict out;
+    out["num_components"] = est.num_components;
+    out["num_boundary_edges"] = est.num_boundary_edges;
+    out["boundary_length"] = est.boundary_length;
+    out["surface_area"] = est.surface_area;
+    out["target_ratio"] = est.target_ratio;
+    out["working_faces"] = est.working_faces;
+    out["peak_memory_bytes"] = est.peak_memory_bytes;
+    out["runtime_seconds"] = est.runtime_seconds;
+    return out;
 }
 
 
@@ -86,6 +629,20 @@ aggressive_sat : bool
     Use aggressive SAT solver.
 minimum_cost_flow : bool
     Use minimum cost flow solver.
+time_budget_ms : float
+    Soft deadline for the whole call in milliseconds; 0 disables.
+reorder_output : bool
+    Reorder faces for vertex-cache locality and vertices by first use.
+encode_position_bits : int
+    If non-zero, return the quantized encoding (bytes) instead of vertices,
+    with positions quantized to this many bits; faces is then None.
+domain_decomposition : bool
+    Smooth the fields as vertex blocks swept in parallel with halo exchange
+    instead of colour by colour.
+balanced_coloring : bool
+    Recolour the hierarchy in parallel with balanced colour classes.
+chaotic_relaxation : bool
+    Barrier-free parallel smoothing sweeps; fastest, not deterministic.
 
 Returns
 -------
@@ -93,15 +650,316 @@ vertices : ndarray, shape (K, 3), dtype float64
     Output quad mesh vertex positions.
 faces : ndarray, shape (L, 4), dtype int32
     Output quad mesh face indices (0-based).
+stats : dict
+    Per-stage wall times and the degradations applied to meet the budget.
+)doc",
+        nb::arg("vertices"),
+        nb::arg("faces"),
+        nb::arg("target_faces"),
+        nb::arg("seed") = 0,
+        nb::arg("preserve_sharp") = false,
+        nb::arg("preserve_boundary") = false,
+        nb::arg("adaptive_scale") = false,
+        nb::arg("aggressive_sat") = false,
+        nb::arg("minimum_cost_flow") = false,
+        nb::arg("time_budget_ms") = 0.0,
+        nb::arg("reorder_output") = false,
+        nb::arg("encode_position_bits") = 0,
+        nb::arg("domain_decomposition") = false,
+        nb::arg("balanced_coloring") = false,
+        nb::arg("chaotic_relaxation") = false
+    );
+
+    m.def("quadriflow_remesh_roi", &py_quadriflow_remesh_roi,
+        R"doc(
+Remesh only the faces selected by face_mask, keeping the rest untouched.
+
+The selected submesh is remeshed with its border pinned (preserve_boundary)
+and the quad patch is zipped to the untouched triangles by a band of
+triangles.
+
+Returns
+-------
+vertices : ndarray, shape (K, 3), dtype float64
+    Original vertices still in use, followed by the quad vertices.
+quads : ndarray, shape (L, 4), dtype int32
+    Quad faces of the remeshed region.
+triangles : ndarray, shape (T, 3), dtype int32
+    Untouched input triangles plus the stitching band.
+stats : dict
+    As for quadriflow_remesh.
+)doc",
+        nb::arg("vertices"),
+        nb::arg("faces"),
+        nb::arg("face_mask"),
+        nb::arg("target_faces"),
+        nb::arg("seed") = 0,
+        nb::arg("preserve_sharp") = false,
+        nb::arg("adaptive_scale") = false,
+        nb::arg("aggressive_sat") = false,
+        nb::arg("minimum_cost_flow") = false,
+        nb::arg("time_budget_ms") = 0.0,
+        nb::arg("reorder_output") = false,
+        nb::arg("domain_decomposition") = false,
+        nb::arg("balanced_coloring") = false
+    );
+
+    m.def("quadriflow_remesh_seeds", &py_quadriflow_remesh_seeds,
+        R"doc(
+Best-of-N remeshing over several seeds sharing one hierarchy build.
+
+The seed-dependent orientation field is solved for every seed in parallel
+threads and scored by its orientation singularity count.
+
+Returns
+-------
+results : list of (vertices, faces, stats)
+    The best result only, or one entry per seed (in order) if return_all.
+    ``stats["seed"]`` and ``stats["singularities"]`` identify each result.
 )doc",
         nb::arg("vertices"),
         nb::arg("faces"),
         nb::arg("target_faces"),
+        nb::arg("seeds"),
+        nb::arg("return_all") = false,
+        nb::arg("preserve_sharp") = false,
+        nb::arg("preserve_boundary") = false,
+        nb::arg("adaptive_scale") = false,
+        nb::arg("aggressive_sat") = false,
+        nb::arg("minimum_cost_flow") = false,
+        nb::arg("time_budget_ms") = 0.0,
+        nb::arg("reorder_output") = false,
+        nb::arg("encode_position_bits") = 0
+    );
+
+    m.def("quadriflow_remesh_batch", &py_quadriflow_remesh_batch,
+        R"doc(
+Remesh many independent meshes with the same options in parallel.
+
+Each mesh is remeshed on one worker thread. On multi-socket machines the
+workers are pinned to NUMA nodes and every node works through its own
+queue of meshes, so each mesh is solved from local memory.
+
+Returns
+-------
+results : list of (vertices, faces, stats)
+    One entry per input mesh, in order. ``stats["numa_node"]`` is the node
+    the mesh ran on.
+)doc",
+        nb::arg("vertices"),
+        nb::arg("faces"),
+        nb::arg("target_faces"),
+        nb::arg("max_workers") = 0,
         nb::arg("seed") = 0,
         nb::arg("preserve_sharp") = false,
         nb::arg("preserve_boundary") = false,
         nb::arg("adaptive_scale") = false,
         nb::arg("aggressive_sat") = false,
-        nb::arg("minimum_cost_flow") = false
+        nb::arg("minimum_cost_flow") = false,
+        nb::arg("time_budget_ms") = 0.0,
+        nb::arg("reorder_output") = false,
+        nb::arg("encode_position_bits") = 0
+    );
+
+    m.def("estimate_resources", &py_estimate_resources,
+        R"doc(
+Predict peak memory and runtime of quadriflow_remesh without running it.
+
+Performs O(M) mesh analysis (surface area, connected components, boundary
+edges, pre-subdivision face count) and applies a linear cost model. The
+default coefficients are uncalibrated placeholders; refit them for absolute
+predictions.
+
+Parameters
+----------
+vertices : ndarray, shape (N, 3), dtype float64
+    Input triangle mesh vertex positions.
+faces : ndarray, shape (M, 3), dtype int32
+    Input triangle mesh face indices (0-based).
+target_faces : int
+    Target number of quad faces in the output.
+preserve_sharp, preserve_boundary, adaptive_scale, aggressive_sat, minimum_cost_flow : bool
+    Same flags as quadriflow_remesh.
+cost_model : dict
+    Overrides for the cost model coefficients (see QuadriFlowCostModel).
+
+Returns
+-------
+estimate : dict
+    Input analysis plus ``peak_memory_bytes`` and ``runtime_seconds``.
+)doc",
+        nb::arg("vertices"),
+        nb::arg("faces"),
+        nb::arg("target_faces"),
+        nb::arg("preserve_sharp") = false,
+        nb::arg("preserve_boundary") = false,
+        nb::arg("adaptive_scale") = false,
+        nb::arg("aggressive_sat") = false,
+        nb::arg("minimum_cost_flow") = false,
+        nb::arg("cost_model") = nb::dict()
     );
+
+    m.def("encode_mesh", &py_encode_mesh,
+        R"doc(
+Encode a quad mesh in the compact quantized format (see pipeline.h).
+
+Positions are quantized to position_bits against the mesh bounding box;
+quad indices are delta- and varint-encoded.
+)doc",
+        nb::arg("vertices"),
+        nb::arg("faces"),
+        nb::arg("position_bits") = 16
+    );
+
+    m.def("decode_mesh", &py_decode_mesh,
+        "Decode a quantized mesh from a uint8 buffer. Returns (vertices, faces).",
+        nb::arg("data")
+    );
+
+    m.def("get_metrics", &py_get_metrics,
+        "Cumulative metrics over all remeshing calls in this process.");
+
+    m.def("reset_metrics", &reset_metrics,
+        "Zero the cumulative metrics.");
+
+    m.def("export_prometheus_metrics", &export_prometheus_metrics,
+        "The cumulative metrics in Prometheus text exposition format.");
+
+    m.def("set_hardware_counters_enabled", &set_hardware_counters_enabled,
+        "Enable or disable per-stage hardware performance counters.",
+        nb::arg("enabled"));
+
+    m.def("hardware_counters_enabled", &hardware_counters_enabled,
+        "Whether per-stage hardware performance counters are enabled.");
+
+    m.def("hardware_counters_available", &hardware_counters_available,
+        "Whether this process may open hardware performance counters.");
+
+    m.def("set_hugepages_enabled", &set_hugepages_enabled,
+        "Enable or disable transparent huge pages for large buffers.",
+        nb::arg("enabled"));
+
+    m.def("hugepages_enabled", &hugepages_enabled,
+        "Whether large buffers are placed on transparent huge pages.");
+
+    m.def("hugepages_available", &hugepages_available,
+        "Whether the kernel provides transparent huge pages.");
+
+    m.def("configure_thread_pool", &configure_thread_pool,
+        "Set the worker count and CPU pinning of the thread pool.",
+        nb::arg("num_threads"), nb::arg("pin_threads"));
+
+    m.def("shutdown_thread_pool", &shutdown_thread_pool,
+        "Stop and join the thread pool's workers.");
+
+    m.def("set_tracing_enabled", &set_tracing_enabled,
+        "Enable or disable process-wide timeline tracing of pipeline stages.",
+        nb::arg("enabled"));
+
+    m.def("tracing_enabled", &tracing_enabled,
+        "Whether timeline tracing is enabled.");
+
+    m.def("export_chrome_trace", &export_chrome_trace,
+        "Trace events recorded since the last clearing export, as Chrome "
+        "trace JSON.",
+        nb::arg("clear") = true);
+
+    nb::class_<QuadriFlowSession>(m, "Remesher",
+        R"doc(
+Persistent remeshing session.
+
+Keeps the loaded mesh, hierarchy and solved fields between calls:
+``preview`` reuses the hierarchy for any target, and ``run`` continues from
+the last preview's fields when the target matches.
+)doc")
+        .def("__init__", &py_remesher_init,
+            nb::arg("vertices"),
+            nb::arg("faces"),
+            nb::arg("seed") = 0,
+            nb::arg("preserve_sharp") = false,
+            nb::arg("preserve_boundary") = false,
+            nb::arg("adaptive_scale") = false,
+            nb::arg("aggressive_sat") = false,
+            nb::arg("minimum_cost_flow") = false,
+            nb::arg("time_budget_ms") = 0.0,
+            nb::arg("reorder_output") = false,
+            nb::arg("domain_decomposition") = false,
+            nb::arg("balanced_coloring") = false,
+            nb::arg("chaotic_relaxation") = false)
+        .def("preview",
+            [](QuadriFlowSession& self, int target_faces) {
+                QuadriFlowResult result;
+                {
+                    nb::gil_scoped_release release;
+                    result = self.preview(target_faces);
+                }
+                return MakeResultTuple(result);
+            },
+            nb::arg("target_faces"),
+            "Approximate remesh from the coarse hierarchy levels, without flow "
+            "optimization. Returns (vertices, faces, stats).")
+        .def("run",
+            [](QuadriFlowSession& self, int target_faces) {
+                QuadriFlowResult result;
+                {
+                    nb::gil_scoped_release release;
+                    result = self.run(target_faces);
+                }
+                return MakeResultTuple(result);
+            },
+            nb::arg("target_faces"),
+            "Full-quality remesh, continuing from the last preview's fields. "
+            "Returns (vertices, faces, stats).")
+        .def_prop_ro("num_levels", &QuadriFlowSession::num_levels)
+        .def_prop_ro("preview_level", &QuadriFlowSession::preview_level)
+        .def("field", &py_remesher_field,
+            nb::arg("name"),
+            nb::arg("level") = 0,
+            "Read-only zero-copy view of solver field V, N, Q, O (n, 3) or "
+            "S (n, 2) at a hierarchy level, in the normalized frame.")
+        .def_prop_ro("normalization",
+            [](const QuadriFlowSession& self) {
+                double offset[3], scale;
+                self.normalization(offset, &scale);
+                return nb::make_tuple(
+                    nb::make_tuple(offset[0], offset[1], offset[2]), scale);
+            },
+            "(offset, scale): input position = normalized * scale + offset.")
+        .def("save_state", &py_remesher_save_state,
+            "Session state as (scalars, [(name, dtype, rows, cols, bytes), ...]) "
+            "with zero-copy byte views of the solver arrays.")
+        .def_static("from_state", &py_remesher_from_state,
+            nb::arg("scalars"), nb::arg("arrays"),
+            nb::rv_policy::take_ownership,
+            "Restore a session from save_state() output without rebuilding "
+            "its hierarchy.");
+
+    nb::class_<QuadriFlowMeshBuilder>(m, "MeshBuilder",
+        R"doc(
+Assembles the input mesh from chunks (e.g. reconstruction tiles).
+
+Each chunk is appended directly into the loader's storage; vertices on a
+chunk's open border are welded to earlier chunks through a spatial hash.
+)doc")
+        .def(nb::init<double>(), nb::arg("weld_tolerance") = 0.0)
+        .def("add_chunk", &py_mesh_builder_add_chunk,
+            nb::arg("vertices"),
+            nb::arg("faces"),
+            "Append a triangle chunk whose faces index its own vertices.")
+        .def_prop_ro("num_vertices", &QuadriFlowMeshBuilder::num_vertices)
+        .def_prop_ro("num_faces", &QuadriFlowMeshBuilder::num_faces)
+        .def("remesh", &py_mesh_builder_remesh,
+            nb::arg("target_faces"),
+            nb::arg("seed") = 0,
+            nb::arg("preserve_sharp") = false,
+            nb::arg("preserve_boundary") = false,
+            nb::arg("adaptive_scale") = false,
+            nb::arg("aggressive_sat") = false,
+            nb::arg("minimum_cost_flow") = false,
+            nb::arg("time_budget_ms") = 0.0,
+            nb::arg("reorder_output") = false,
+            nb::arg("domain_decomposition") = false,
+            nb::arg("balanced_coloring") = false,
+            "Remesh the accumulated mesh; the builder is empty afterwards. "
+            "Returns (vertices, faces, stats).");
 }
@@ -0,0 +1,103 @@
+// Counting replacements of the global allocation functions, compiled only
+// with PYQUADRIFLOW_ALLOC_STATS. Blocks come straight from malloc and are
+// measured with malloc_usable_size, so memory allocated or freed by code
+// outside the module (plain malloc-backed operator new) stays compatible.
+
+#include "alloc_stats.h"
+
+#ifdef PYQUADRIFLOW_ALLOC_STATS
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#ifndef __GLIBC__
+#error "PYQUADRIFLOW_ALLOC_STATS needs glibc (malloc_usable_size)"
+#endif
+#include <malloc.h>
+
+namespace {
+
+thread_local AllocationCounters t_counters;
+
+inline void* Allocate(std::size_t size, std::size_t alignment) {
+    if (size == 0) size = 1;
+    void* p = nullptr;
+    if (alignment <= alignof(std::max_align_t)) {
+        p = std::malloc(size);
+    } else if (posix_memalign(&p, alignment, size) != 0) {
+        p = nullptr;
+    }
+    if (p) {
+        const std::size_t usable = malloc_usable_size(p);
+        AllocationCounters& c = t_counters;
+        c.allocations += 1;
+        c.bytes_allocated += usable;
+        c.live_bytes += (int64_t)usable;
+        if (c.live_bytes > c.peak_bytes) c.peak_bytes = c.live_bytes;
+    }
+    return p;
+}
+
+inline void* AllocateOrThrow(std::size_t size, std::size_t alignment) {
+    for (;;) {
+        if (void* p = Allocate(size, alignment)) return p;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+inline void Free(void* p) noexcept {
+    if (!p) return;
+    const std::size_t usable = malloc_usable_size(p);
+    AllocationCounters& c = t_counters;
+    c.frees += 1;
+    c.bytes_freed += usable;
+    c.live_bytes -= (int64_t)usable;
+    std::free(p);
+}
+
+const std::size_t kDefaultAlignment = alignof(std::max_align_t);
+
+} // namespace
+
+AllocationCounters& ThreadAllocations() {
+    return t_counters;
+}
+
+void* operator new(std::size_t size) { return AllocateOrThrow(size, kDefaultAlignment); }
+void* operator new[](std::size_t size) { return AllocateOrThrow(size, kDefaultAlignment); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return Allocate(size, kDefaultAlignment);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return Allocate(size, kDefaultAlignment);
+}
+void* operator new(std::size_t size, std::align_val_t al) {
+    return AllocateOrThrow(size, (std::size_t)al);
+}
+void* operator new[](std::size_t size, std::align_val_t al) {
+    return AllocateOrThrow(size, (std::size_t)al);
+}
+void* operator new(std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return Allocate(size, (std::size_t)al);
+}
+void* operator new[](std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return Allocate(size, (std::size_t)al);
+}
+
+void operator delete(void* p) noexcept { Free(p); }
+void operator delete[](void* p) noexcept { Free(p); }
+void operator delete(void* p, std::size_t) noexcept { Free(p); }
+void operator delete[](void* p, std::size_t) noexcept { Free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { Free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { Free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { Free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { Free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { Free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { Free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { Free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { Free(p); }
+
+#endif // PYQUADRIFLOW_ALLOC_STATS
@@ -0,0 +1,88 @@
+// Allocation accounting for pipeline stages.
+// Pure C++ — no QuadriFlow headers.
+//
+// Built with PYQUADRIFLOW_ALLOC_STATS (CMake option of the same name),
+// alloc_stats.cpp replaces the global operator new / delete of the module
+// with counting versions over malloc / free and keeps the counters in
+// thread-local storage. Without it every call below is an empty inline.
+
+#ifndef PYQUADRIFLOW_ALLOC_STATS_H
+#define PYQUADRIFLOW_ALLOC_STATS_H
+
+#include <algorithm>
+#include <cstdint>
+
+// Trivially constructible, so it is safe to touch from operator new.
+struct AllocationCounters {
+    uint64_t allocations;
+    uint64_t frees;
+    uint64_t bytes_allocated;
+    uint64_t bytes_freed;
+    int64_t live_bytes;   // allocated - freed by this thread
+    int64_t peak_bytes;   // high-water mark of live_bytes
+};
+
+#ifdef PYQUADRIFLOW_ALLOC_STATS
+const bool kAllocationAccounting = true;
+AllocationCounters& ThreadAllocations();
+#else
+const bool kAllocationAccounting = false;
+inline AllocationCounters& ThreadAllocations() {
+    static thread_local AllocationCounters unused;
+    return unused;
+}
+#endif
+
+// Activity of the calling thread between construction and Finish(). The
+// returned peak_bytes is the high-water mark above the starting live size.
+class AllocationScope {
+public:
+    AllocationScope() {
+        if (!kAllocationAccounting) return;
+        AllocationCounters& c = ThreadAllocations();
+        start_ = c;
+        c.peak_bytes = c.live_bytes;
+    }
+
+    AllocationCounters Finish() {
+        AllocationCounters delta = {};
+        if (!kAllocationAccounting) return delta;
+        AllocationCounters& c = ThreadAllocations();
+        delta.allocations = c.allocations - start_.allocations;
+        delta.frees = c.frees - start_.frees;
+        delta.bytes_allocated = c.bytes_allocated - start_.bytes_allocated;
+        delta.bytes_freed = c.bytes_freed - start_.bytes_freed;
+        delta.live_bytes = c.live_bytes - start_.live_bytes;
+        delta.peak_bytes = c.peak_bytes - start_.live_bytes;
+        c.peak_bytes = std::max(c.peak_bytes, start_.peak_bytes);  // nested scopes
+        return delta;
+    }
+
+private:
+    AllocationCounters start_ = {};
+};
+
+// Fold the activity of worker threads (sums of their scope deltas) into the
+// calling thread, so the enclosing stage accounts for it. Worker peaks are
+// assumed to coincide, which bounds the combined high-water mark.
+inline void MergeAllocations(const AllocationCounters& workers) {
+    if (!kAllocationAccounting) return;
+    AllocationCounters& c = ThreadAllocations();
+    c.allocations += workers.allocations;
+    c.frees += workers.frees;
+    c.bytes_allocated += workers.bytes_allocated;
+    c.bytes_freed += workers.bytes_freed;
+    c.peak_bytes = std::max(c.peak_bytes, c.live_bytes + workers.peak_bytes);
+    c.live_bytes += workers.live_bytes;
+}
+
+inline void AccumulateAllocations(AllocationCounters& sum, const AllocationCounters& delta) {
+    sum.allocations += delta.allocations;
+    sum.frees += delta.frees;
+    sum.bytes_allocated += delta.bytes_allocated;
+    sum.bytes_freed += delta.bytes_freed;
+    sum.live_bytes += delta.live_bytes;
+    sum.peak_bytes += delta.peak_bytes;
+}
+
+#endif // PYQUADRIFLOW_ALLOC_STATS_H
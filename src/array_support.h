@@ -2,53 +2,44 @@
 #define ARRAY_SUPPORT_HEADER_H
 
 #include <array>
+#include <cstring>
 
 #include <nanobind/nanobind.h>
 #include <nanobind/ndarray.h>
 
-#if defined(__linux__) || defined(__APPLE__)
-#include <sys/mman.h>
-#endif
+#include "hugepages.h"
 
 namespace nb = nanobind;
 
 template <typename T, size_t N>
 using NDArray = nb::ndarray<nb::numpy, T, nb::ndim<N>, nb::c_contig>;
 
+// Release with HugePageFree. Large arrays start on a 2 MB boundary and are
+// advised for huge pages before first touch (see hugepages.h).
 template <typename T> T *AllocateArray(size_t total, bool zero_initialize = false) {
-    T *data = zero_initialize ? new T[total]() : new T[total];
-
-#ifdef __linux__
-    const size_t hugepage_threshold = 1u << 22u; // 4MB threshold
-    const size_t page_size = 4096u;
-
-    if (total * sizeof(T) >= hugepage_threshold) {
-        uintptr_t data_addr = reinterpret_cast<uintptr_t>(data);
-        size_t offset = page_size - (data_addr % page_size);
-        size_t length = total * sizeof(T) - offset;
-
-        madvise(reinterpret_cast<void *>(data_addr + offset), length, MADV_HUGEPAGE);
+    T *data = static_cast<T *>(HugePageAllocate(total * sizeof(T)));
+    if (zero_initialize && total > 0) {
+        std::memset(data, 0, total * sizeof(T));
     }
-#endif
-
     return data;
 }
 
+// Takes ownership of `data`, which must come from AllocateArray.
 template <typename T, size_t N>
 NDArray<T, N>
-WrapNDarray(T *data, const std::array<int, N> shape, bool zero_initialize = false) {
+WrapNDarray(T *data, const std::array<size_t, N> shape, bool zero_initialize = false) {
     size_t shape_[N];
     for (size_t i = 0; i < N; ++i) {
         shape_[i] = shape[i];
     }
 
-    nb::capsule owner(data, [](void *p) noexcept { delete[] (T *)p; });
+    nb::capsule owner(data, [](void *p) noexcept { HugePageFree(p); });
 
     return NDArray<T, N>(data, N, shape_, owner);
 }
 
 template <typename T, size_t N>
-NDArray<T, N> MakeNDArray(const std::array<int, N> shape, bool zero_initialize = false) {
+NDArray<T, N> MakeNDArray(const std::array<size_t, N> shape, bool zero_initialize = false) {
 
     size_t total = 1;
     for (size_t i = 0; i < N; i++) {
@@ -61,7 +52,7 @@ NDArray<T, N> MakeNDArray(const std::array<int, N> shape, bool zero_initialize =
     }
 
     T *data = AllocateArray<T>(total, zero_initialize);
-    nb::capsule owner(data, [](void *p) noexcept { delete[] (T *)p; });
+    nb::capsule owner(data, [](void *p) noexcept { HugePageFree(p); });
 
     return NDArray<T, N>(data, N, shape_, owner);
 }
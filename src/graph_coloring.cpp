@@ -0,0 +1,153 @@
+// Jones-Plassmann colouring with colour-class balancing behind
+// graph_coloring.h.
+
+#include "graph_coloring.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "pipeline.h"
+#include "trace.h"
+
+using namespace qflow;
+
+namespace {
+
+// Vertices per parallel work item
+const int kColoringChunk = 4096;
+
+uint64_t Priority(int i) {
+    // splitmix64 finalizer; the index breaks the (unlikely) ties
+    uint64_t x = (uint64_t)i + 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return ((x ^ (x >> 31)) & ~0xffffffffull) | (uint32_t)i;
+}
+
+// Run body(begin, end) over [0, n) in chunks on the executor
+template <typename Body>
+void ParallelChunks(QuadriFlowExecutor& executor, int n, const Body& body) {
+    const int chunks = (n + kColoringChunk - 1) / kColoringChunk;
+    if (chunks <= 1) {
+        if (n > 0) body(0, n);
+        return;
+    }
+    executor.parallel_for(chunks, [&](int c) {
+        body(c * kColoringChunk, std::min(n, (c + 1) * kColoringChunk));
+    });
+}
+
+// Smallest colour no neighbour of i has; `used` is scratch, all false
+int FirstFreeColor(const AdjacentMatrix& adj, const std::vector<int>& color, int i,
+                   std::vector<char>& used) {
+    const int limit = (int)adj[i].size() + 1;
+    if ((int)used.size() < limit) used.resize(limit, 0);
+    for (const auto& link : adj[i]) {
+        const int c = link.id != i ? color[link.id] : -1;
+        if (c >= 0 && c < limit) used[c] = 1;
+    }
+    int free = 0;
+    while (used[free]) ++free;
+    for (const auto& link : adj[i]) {
+        const int c = link.id != i ? color[link.id] : -1;
+        if (c >= 0 && c < limit) used[c] = 0;
+    }
+    return free;
+}
+
+} // namespace
+
+bool BalancedGraphColoring(const AdjacentMatrix& adj, std::vector<std::vector<int>>& phases) {
+    const int n = (int)adj.size();
+    const std::shared_ptr<QuadriFlowExecutor> executor = get_executor();
+    std::vector<int> color(n, -1);
+
+    // Jones-Plassmann: each round colours the uncoloured vertices whose
+    // priority beats every uncoloured neighbour. Those form an independent
+    // set, so they are coloured from the earlier rounds' colours only and
+    // commit after the round.
+    std::vector<int> pending(n), next(n, -1);
+    for (int i = 0; i < n; ++i) pending[i] = i;
+    while (!pending.empty()) {
+        TraceScope trace("coloring.round", (int)pending.size());
+        ParallelChunks(*executor, (int)pending.size(), [&](int begin, int end) {
+            std::vector<char> used;
+            for (int k = begin; k < end; ++k) {
+                const int i = pending[k];
+                const uint64_t p = Priority(i);
+                bool local_max = true;
+                for (const auto& link : adj[i]) {
+                    const int j = link.id;
+                    if (j != i && color[j] < 0 && Priority(j) > p) {
+                        local_max = false;
+                        break;
+                    }
+                }
+                if (local_max) next[i] = FirstFreeColor(adj, color, i, used);
+            }
+        });
+        ParallelChunks(*executor, (int)pending.size(), [&](int begin, int end) {
+            for (int k = begin; k < end; ++k) color[pending[k]] = next[pending[k]];
+        });
+        pending.erase(std::remove_if(pending.begin(), pending.end(),
+                                     [&](int i) { return color[i] >= 0; }),
+                      pending.end());
+    }
+
+    // Balance: move vertices of oversized classes, in index order, to the
+    // first undersized class none of their neighbours is in
+    const int num_colors = n > 0 ? *std::max_element(color.begin(), color.end()) + 1 : 0;
+    std::vector<int64_t> sizes(num_colors, 0);
+    for (int i = 0; i < n; ++i) ++sizes[color[i]];
+    const int64_t target = num_colors > 0 ? (n + num_colors - 1) / num_colors : 0;
+    {
+        TraceScope trace("coloring.balance");
+        std::vector<char> used(num_colors, 0);
+        for (int i = 0; i < n; ++i) {
+            const int c = color[i];
+            if (sizes[c] <= target) continue;
+            for (const auto& link : adj[i]) {
+                if (link.id != i) used[color[link.id]] = 1;
+            }
+            for (int d = 0; d < num_colors; ++d) {
+                if (sizes[d] < target && !used[d]) {
+                    --sizes[c];
+                    ++sizes[d];
+                    color[i] = d;
+                    break;
+                }
+            }
+            for (const auto& link : adj[i]) {
+                if (link.id != i) used[color[link.id]] = 0;
+            }
+        }
+    }
+
+    // Both steps only ever look at adj[i] from i; with a one-sided link
+    // two neighbours can still share a colour
+    std::atomic<bool> proper(true);
+    ParallelChunks(*executor, n, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            for (const auto& link : adj[i]) {
+                if (link.id != i && color[link.id] == color[i]) proper = false;
+            }
+        }
+    });
+    if (!proper) return false;
+
+    std::vector<std::vector<int>> result(num_colors);
+    for (int c = 0; c < num_colors; ++c) result[c].reserve((size_t)sizes[c]);
+    for (int i = 0; i < n; ++i) result[color[i]].push_back(i);
+    phases.swap(result);
+    return true;
+}
+
+void BalanceHierarchyPhases(Hierarchy& mRes) {
+    for (size_t level = 0; level < mRes.mAdj.size(); ++level) {
+        TraceScope trace("coloring.level", (int)level);
+        BalancedGraphColoring(mRes.mAdj[level], mRes.mPhases[level]);
+    }
+}
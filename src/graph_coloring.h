@@ -0,0 +1,29 @@
+// Parallel, balanced colouring of the hierarchy levels into smoothing phases.
+// Includes QuadriFlow headers — pipeline-side translation units only.
+//
+// Upstream colours every level greedily on one thread, which leaves a few
+// large phases and a long tail of small ones that cannot keep the workers of
+// a phase sweep busy. Here the colouring runs as Jones-Plassmann rounds on
+// the executor, and a balancing pass then moves vertices out of oversized
+// colour classes into undersized ones they have no neighbour in.
+
+#ifndef PYQUADRIFLOW_GRAPH_COLORING_H
+#define PYQUADRIFLOW_GRAPH_COLORING_H
+
+#include <vector>
+
+#include "hierarchy.hpp"
+
+// Colour the graph `adj` and return the vertices of each colour in
+// ascending order. Priorities are a hash of the vertex index, so the
+// phases do not depend on the thread count. Returns false, leaving
+// `phases` untouched, if the adjacency is not symmetric and the colouring
+// therefore not proper.
+bool BalancedGraphColoring(const qflow::AdjacentMatrix& adj,
+                           std::vector<std::vector<int>>& phases);
+
+// Recolour every level of mRes, keeping upstream's phases on levels where
+// BalancedGraphColoring fails.
+void BalanceHierarchyPhases(qflow::Hierarchy& mRes);
+
+#endif // PYQUADRIFLOW_GRAPH_COLORING_H
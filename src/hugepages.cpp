@@ -0,0 +1,112 @@
+// Huge-page allocation and advice behind hugepages.h.
+
+#include "hugepages.h"
+
+#include "pipeline.h"
+
+#include <cstdint>
+#include <cstdlib>
+
+#ifdef __linux__
+#include <sys/mman.h>
+
+#include <fstream>
+#include <string>
+
+#ifndef MADV_COLLAPSE
+#define MADV_COLLAPSE 25  // Linux 6.1; older kernels reject it with EINVAL
+#endif
+#endif
+
+std::atomic<bool> g_hugepages_enabled{true};
+
+#ifdef __linux__
+
+namespace {
+
+// Whole 2 MB pages inside [data, data + bytes); false when there are none.
+bool HugePageRange(void* data, size_t bytes, void** begin, size_t* length) {
+    const uintptr_t start = reinterpret_cast<uintptr_t>(data);
+    const uintptr_t first = (start + kHugePageSize - 1) & ~(uintptr_t)(kHugePageSize - 1);
+    const uintptr_t last = (start + bytes) & ~(uintptr_t)(kHugePageSize - 1);
+    if (last <= first) return false;
+    *begin = reinterpret_cast<void*>(first);
+    *length = last - first;
+    return true;
+}
+
+} // namespace
+
+void* HugePageAllocate(size_t bytes) {
+    if (bytes < kHugePageThreshold || !HugePagesEnabled()) {
+        void* data = std::malloc(bytes > 0 ? bytes : 1);
+        if (!data) throw std::bad_alloc();
+        return data;
+    }
+    // Whole huge pages, so the tail of the buffer is covered too
+    const size_t rounded = (bytes + kHugePageSize - 1) & ~(kHugePageSize - 1);
+    void* data = nullptr;
+    if (posix_memalign(&data, kHugePageSize, rounded) != 0) throw std::bad_alloc();
+    madvise(data, rounded, MADV_HUGEPAGE);
+    return data;
+}
+
+void AdviseHugePages(void* data, size_t bytes) {
+    void* begin;
+    size_t length;
+    if (bytes < kHugePageThreshold || !HugePagesEnabled() ||
+        !HugePageRange(data, bytes, &begin, &length)) {
+        return;
+    }
+    madvise(begin, length, MADV_HUGEPAGE);
+}
+
+size_t CollapseHugePages(void* data, size_t bytes) {
+    void* begin;
+    size_t length;
+    if (bytes < kHugePageThreshold || !HugePagesEnabled() ||
+        !HugePageRange(data, bytes, &begin, &length)) {
+        return 0;
+    }
+    madvise(begin, length, MADV_HUGEPAGE);
+    return madvise(begin, length, MADV_COLLAPSE) == 0 ? length : 0;
+}
+
+bool hugepages_available() {
+    std::ifstream file("/sys/kernel/mm/transparent_hugepage/enabled");
+    std::string modes;
+    if (!std::getline(file, modes)) return false;
+    return modes.find("[never]") == std::string::npos;
+}
+
+#else
+
+void* HugePageAllocate(size_t bytes) {
+    void* data = std::malloc(bytes > 0 ? bytes : 1);
+    if (!data) throw std::bad_alloc();
+    return data;
+}
+
+void AdviseHugePages(void*, size_t) {}
+
+size_t CollapseHugePages(void*, size_t) {
+    return 0;
+}
+
+bool hugepages_available() {
+    return false;
+}
+
+#endif
+
+void HugePageFree(void* data) {
+    std::free(data);
+}
+
+void set_hugepages_enabled(bool enabled) {
+    g_hugepages_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool hugepages_enabled() {
+    return g_hugepages_enabled.load(std::memory_order_relaxed);
+}
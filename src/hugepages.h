@@ -0,0 +1,69 @@
+// 2 MB-aligned, transparent-hugepage-backed storage for large buffers.
+// Pure C++ — no QuadriFlow headers.
+//
+// The solver gathers neighbour data across arrays of hundreds of megabytes;
+// with 4 KB pages nearly every such access is a TLB miss. Buffers of at
+// least kHugePageThreshold bytes are placed on 2 MB boundaries and advised
+// MADV_HUGEPAGE before first touch, so the kernel can back them with huge
+// pages (THP "always" or "madvise" mode). Smaller buffers, disabled huge
+// pages and other platforms fall back to plain malloc.
+//
+// The storage comes from malloc / posix_memalign, so PYQUADRIFLOW_ALLOC_STATS
+// builds (which count operator new) do not see it.
+
+#ifndef PYQUADRIFLOW_HUGEPAGES_H
+#define PYQUADRIFLOW_HUGEPAGES_H
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+const size_t kHugePageSize = size_t(2) << 20;
+const size_t kHugePageThreshold = size_t(4) << 20;
+
+extern std::atomic<bool> g_hugepages_enabled;
+
+inline bool HugePagesEnabled() {
+    return g_hugepages_enabled.load(std::memory_order_relaxed);
+}
+
+// Uninitialized storage for `bytes`, never null (throws std::bad_alloc).
+// Release with HugePageFree.
+void* HugePageAllocate(size_t bytes);
+void HugePageFree(void* data);
+
+// Advise the whole 2 MB pages inside [data, data + bytes) of a buffer that
+// was allocated elsewhere. Call before the buffer is first written.
+void AdviseHugePages(void* data, size_t bytes);
+
+// Same for a buffer that is already populated: its whole 2 MB pages are
+// collapsed into huge pages synchronously (MADV_COLLAPSE, Linux 6.1+).
+// Returns the bytes collapsed.
+size_t CollapseHugePages(void* data, size_t bytes);
+
+// std::allocator replacement for the large solver-side vectors.
+template <typename T>
+struct HugePageAllocator {
+    using value_type = T;
+
+    HugePageAllocator() = default;
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        if (n > size_t(-1) / sizeof(T)) throw std::bad_alloc();
+        return static_cast<T*>(HugePageAllocate(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_t) { HugePageFree(p); }
+
+    template <typename U>
+    bool operator==(const HugePageAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const HugePageAllocator<U>&) const { return false; }
+};
+
+template <typename T>
+using HugePageVector = std::vector<T, HugePageAllocator<T>>;
+
+#endif // PYQUADRIFLOW_HUGEPAGES_H
@@ -0,0 +1,119 @@
+// Vertex-cache and locality-optimized ordering of output meshes.
+
+#include "mesh_reorder.h"
+
+#include <cstddef>
+
+namespace {
+
+// Next fanning vertex: the candidate that stays in the cache longest while
+// its remaining faces are emitted, else a dead end, else the next vertex
+// in input order that still has faces.
+int NextFanningVertex(
+    const std::vector<int>& candidates, const std::vector<int>& live,
+    const std::vector<int>& cache_time, int time, int cache_size, int arity,
+    std::vector<int>& dead_ends, int& cursor
+) {
+    int best = -1, best_priority = -1;
+    for (int v : candidates) {
+        if (live[v] == 0) continue;
+        int priority = 0;
+        if (time - cache_time[v] + (arity - 1) * live[v] <= cache_size) {
+            priority = time - cache_time[v];
+        }
+        if (priority > best_priority) {
+            best = v;
+            best_priority = priority;
+        }
+    }
+    if (best != -1) return best;
+
+    while (!dead_ends.empty()) {
+        const int v = dead_ends.back();
+        dead_ends.pop_back();
+        if (live[v] > 0) return v;
+    }
+    while (cursor < (int)live.size()) {
+        if (live[cursor] > 0) return cursor;
+        ++cursor;
+    }
+    return -1;
+}
+
+} // namespace
+
+void ReorderForVertexCache(
+    std::vector<double>& vertices,
+    std::vector<int>& faces,
+    int arity,
+    int cache_size
+) {
+    // Vertex and face ids are int; corner offsets may exceed 2^31
+    const int num_vertices = (int)(vertices.size() / 3);
+    const int num_faces = (int)(faces.size() / arity);
+    if (num_faces == 0) return;
+
+    // Vertex -> face adjacency (CSR)
+    std::vector<size_t> offset((size_t)num_vertices + 1, 0);
+    for (int v : faces) ++offset[(size_t)v + 1];
+    for (int v = 0; v < num_vertices; ++v) offset[v + 1] += offset[v];
+    std::vector<int> adjacent(faces.size());
+    {
+        std::vector<size_t> fill(offset.begin(), offset.end() - 1);
+        for (int f = 0; f < num_faces; ++f) {
+            for (int k = 0; k < arity; ++k) adjacent[fill[faces[(size_t)f * arity + k]]++] = f;
+        }
+    }
+
+    // 1. Face order (Tipsify)
+    std::vector<int> live(num_vertices);
+    for (int v = 0; v < num_vertices; ++v) live[v] = (int)(offset[v + 1] - offset[v]);
+    std::vector<int> cache_time(num_vertices, -(cache_size + 1));
+    std::vector<char> emitted(num_faces, 0);
+    std::vector<int> dead_ends, candidates, order;
+    order.reserve(num_faces);
+    int time = cache_size + 1, cursor = 0;
+
+    int fan = faces[0];
+    while (fan != -1) {
+        candidates.clear();
+        for (size_t a = offset[fan]; a < offset[fan + 1]; ++a) {
+            const int f = adjacent[a];
+            if (emitted[f]) continue;
+            emitted[f] = 1;
+            order.push_back(f);
+            for (int k = 0; k < arity; ++k) {
+                const int v = faces[(size_t)f * arity + k];
+                dead_ends.push_back(v);
+                candidates.push_back(v);
+                --live[v];
+                if (time - cache_time[v] > cache_size) cache_time[v] = time++;
+            }
+        }
+        fan = NextFanningVertex(candidates, live, cache_time, time, cache_size, arity,
+                                dead_ends, cursor);
+    }
+
+    // 2. Vertex order: first use in the new face order; unused ones last
+    std::vector<int> remap(num_vertices, -1);
+    int next = 0;
+    std::vector<int> new_faces(faces.size());
+    for (int i = 0; i < num_faces; ++i) {
+        const int f = order[i];
+        for (int k = 0; k < arity; ++k) {
+            int& v = remap[faces[(size_t)f * arity + k]];
+            if (v == -1) v = next++;
+            new_faces[(size_t)i * arity + k] = v;
+        }
+    }
+    for (int v = 0; v < num_vertices; ++v) {
+        if (remap[v] == -1) remap[v] = next++;
+    }
+
+    std::vector<double> new_vertices(vertices.size());
+    for (int v = 0; v < num_vertices; ++v) {
+        for (int d = 0; d < 3; ++d) new_vertices[(size_t)remap[v] * 3 + d] = vertices[(size_t)v * 3 + d];
+    }
+    vertices.swap(new_vertices);
+    faces.swap(new_faces);
+}
@@ -0,0 +1,22 @@
+// Vertex-cache and locality-optimized ordering of output meshes.
+// Pure C++ — no QuadriFlow headers.
+
+#ifndef PYQUADRIFLOW_MESH_REORDER_H
+#define PYQUADRIFLOW_MESH_REORDER_H
+
+#include <vector>
+
+// Reorder the faces of a mesh with `arity` corners per face (flat indices)
+// for a FIFO post-transform vertex cache of `cache_size` entries, then
+// renumber the vertices (flat xyz) in order of first use. Faces are
+// ordered with Tipsify (Sander et al. 2007), adapted to polygons: a face
+// adds at most arity - 1 new vertices to the cache instead of 2.
+// O(faces * arity) time, linear in memory.
+void ReorderForVertexCache(
+    std::vector<double>& vertices,
+    std::vector<int>& faces,
+    int arity,
+    int cache_size = 32
+);
+
+#endif // PYQUADRIFLOW_MESH_REORDER_H
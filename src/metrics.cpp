@@ -0,0 +1,209 @@
+// Lock-free metrics registry and its Prometheus text export.
+
+#include "metrics.h"
+
+#include "pipeline.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+const double kBucketBounds[] = {
+    0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1.0, 5.0, 10.0, 30.0, 60.0, 300.0,
+};
+const int kNumBuckets = sizeof(kBucketBounds) / sizeof(kBucketBounds[0]);
+const int kMaxStages = 32;
+
+struct StageSlot {
+    std::atomic<const char*> name{nullptr};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> total_ns{0};
+    std::atomic<uint64_t> buckets[kNumBuckets];  // non-cumulative
+
+    StageSlot() {
+        for (auto& b : buckets) b.store(0, std::memory_order_relaxed);
+    }
+};
+
+struct Registry {
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> failures{0};
+    std::atomic<uint64_t> input_faces{0};
+    std::atomic<uint64_t> output_faces{0};
+    std::atomic<int64_t> peak_memory_bytes{0};
+    StageSlot stages[kMaxStages];
+};
+
+Registry& GetRegistry() {
+    static Registry registry;
+    return registry;
+}
+
+// Slot of `name`, claiming the first free one on first use; null when all
+// slots are taken by other names.
+StageSlot* FindStage(const char* name) {
+    for (StageSlot& slot : GetRegistry().stages) {
+        const char* current = slot.name.load(std::memory_order_acquire);
+        if (!current && slot.name.compare_exchange_strong(
+                current, name, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return &slot;
+        }
+        if (current == name || std::strcmp(current, name) == 0) return &slot;
+    }
+    return nullptr;
+}
+
+int64_t PeakResidentBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    return (int64_t)counters.PeakWorkingSetSize;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return (int64_t)usage.ru_maxrss;           // bytes
+#else
+    return (int64_t)usage.ru_maxrss * 1024;    // kilobytes
+#endif
+#endif
+}
+
+void AtomicMax(std::atomic<int64_t>& target, int64_t value) {
+    int64_t current = target.load(std::memory_order_relaxed);
+    while (current < value &&
+           !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+void AppendCounter(std::string& out, const char* name, const char* type,
+                   const char* help, double value) {
+    char buffer[256];
+    std::snprintf(buffer, sizeof(buffer), "# HELP %s %s\n# TYPE %s %s\n%s %.17g\n",
+                  name, help, name, type, name, value);
+    out += buffer;
+}
+
+} // namespace
+
+void MetricsRecordStage(const char* name, double seconds) {
+    StageSlot* slot = FindStage(name);
+    if (!slot) return;
+    int bucket = 0;
+    while (bucket < kNumBuckets && seconds > kBucketBounds[bucket]) ++bucket;
+    slot->count.fetch_add(1, std::memory_order_relaxed);
+    if (bucket < kNumBuckets) slot->buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    slot->total_ns.fetch_add((uint64_t)std::llround(seconds * 1e9), std::memory_order_relaxed);
+}
+
+MetricsCallScope::MetricsCallScope(int64_t input_faces) {
+    Registry& r = GetRegistry();
+    r.calls.fetch_add(1, std::memory_order_relaxed);
+    if (input_faces > 0) r.input_faces.fetch_add((uint64_t)input_faces, std::memory_order_relaxed);
+}
+
+MetricsCallScope::~MetricsCallScope() {
+    Registry& r = GetRegistry();
+    if (!succeeded_) r.failures.fetch_add(1, std::memory_order_relaxed);
+    AtomicMax(r.peak_memory_bytes, PeakResidentBytes());
+}
+
+void MetricsCallScope::Succeeded(int64_t output_faces) {
+    succeeded_ = true;
+    GetRegistry().output_faces.fetch_add((uint64_t)output_faces, std::memory_order_relaxed);
+}
+
+QuadriFlowMetrics get_metrics() {
+    Registry& r = GetRegistry();
+    QuadriFlowMetrics metrics;
+    metrics.calls = r.calls.load(std::memory_order_relaxed);
+    metrics.failures = r.failures.load(std::memory_order_relaxed);
+    metrics.input_faces = r.input_faces.load(std::memory_order_relaxed);
+    metrics.output_faces = r.output_faces.load(std::memory_order_relaxed);
+    metrics.peak_memory_bytes = r.peak_memory_bytes.load(std::memory_order_relaxed);
+    metrics.bucket_bounds.assign(kBucketBounds, kBucketBounds + kNumBuckets);
+
+    for (StageSlot& slot : r.stages) {
+        const char* name = slot.name.load(std::memory_order_acquire);
+        if (!name) break;
+        QuadriFlowStageMetrics stage;
+        stage.name = name;
+        stage.count = slot.count.load(std::memory_order_relaxed);
+        stage.total_seconds = slot.total_ns.load(std::memory_order_relaxed) * 1e-9;
+        uint64_t cumulative = 0;
+        for (const auto& b : slot.buckets) {
+            cumulative += b.load(std::memory_order_relaxed);
+            stage.buckets.push_back(cumulative);
+        }
+        // Observations recorded between the loads above
+        if (stage.count < cumulative) stage.count = cumulative;
+        metrics.stages.push_back(std::move(stage));
+    }
+    return metrics;
+}
+
+void reset_metrics() {
+    Registry& r = GetRegistry();
+    r.calls.store(0, std::memory_order_relaxed);
+    r.failures.store(0, std::memory_order_relaxed);
+    r.input_faces.store(0, std::memory_order_relaxed);
+    r.output_faces.store(0, std::memory_order_relaxed);
+    r.peak_memory_bytes.store(0, std::memory_order_relaxed);
+    // Stage names stay claimed, so the export order is stable
+    for (StageSlot& slot : r.stages) {
+        slot.count.store(0, std::memory_order_relaxed);
+        slot.total_ns.store(0, std::memory_order_relaxed);
+        for (auto& b : slot.buckets) b.store(0, std::memory_order_relaxed);
+    }
+}
+
+std::string export_prometheus_metrics() {
+    const QuadriFlowMetrics m = get_metrics();
+    std::string out;
+    AppendCounter(out, "quadriflow_calls_total", "counter",
+                  "Remeshing calls.", (double)m.calls);
+    AppendCounter(out, "quadriflow_failures_total", "counter",
+                  "Remeshing calls that failed.", (double)m.failures);
+    AppendCounter(out, "quadriflow_input_faces_total", "counter",
+                  "Input triangles over all calls.", (double)m.input_faces);
+    AppendCounter(out, "quadriflow_output_faces_total", "counter",
+                  "Output quads over all successful calls.", (double)m.output_faces);
+    AppendCounter(out, "quadriflow_peak_memory_bytes", "gauge",
+                  "Peak resident set size of the process at call end.",
+                  (double)m.peak_memory_bytes);
+    if (m.stages.empty()) return out;
+
+    out += "# HELP quadriflow_stage_seconds Wall time per pipeline stage.\n"
+           "# TYPE quadriflow_stage_seconds histogram\n";
+    char buffer[256];
+    for (const auto& stage : m.stages) {
+        const char* name = stage.name.c_str();
+        for (size_t i = 0; i < m.bucket_bounds.size(); ++i) {
+            std::snprintf(buffer, sizeof(buffer),
+                          "quadriflow_stage_seconds_bucket{stage=\"%s\",le=\"%g\"} %llu\n",
+                          name, m.bucket_bounds[i], (unsigned long long)stage.buckets[i]);
+            out += buffer;
+        }
+        std::snprintf(buffer, sizeof(buffer),
+                      "quadriflow_stage_seconds_bucket{stage=\"%s\",le=\"+Inf\"} %llu\n"
+                      "quadriflow_stage_seconds_sum{stage=\"%s\"} %.17g\n"
+                      "quadriflow_stage_seconds_count{stage=\"%s\"} %llu\n",
+                      name, (unsigned long long)stage.count, name, stage.total_seconds,
+                      name, (unsigned long long)stage.count);
+        out += buffer;
+    }
+    return out;
+}
@@ -0,0 +1,32 @@
+// Process-wide cumulative metrics over all remeshing calls.
+// Pure C++ — no QuadriFlow headers.
+//
+// Every counter is a relaxed atomic; recording never takes a lock. Stage
+// slots are claimed once per distinct stage name with a compare-and-swap.
+
+#ifndef PYQUADRIFLOW_METRICS_H
+#define PYQUADRIFLOW_METRICS_H
+
+#include <cstdint>
+#include <exception>
+
+// Add one observation of stage `name` (a string literal) to its histogram.
+void MetricsRecordStage(const char* name, double seconds);
+
+// Counts one remeshing call: a failure unless Succeeded() is called before
+// the scope ends.
+class MetricsCallScope {
+public:
+    explicit MetricsCallScope(int64_t input_faces);
+    ~MetricsCallScope();
+
+    void Succeeded(int64_t output_faces);
+
+    MetricsCallScope(const MetricsCallScope&) = delete;
+    MetricsCallScope& operator=(const MetricsCallScope&) = delete;
+
+private:
+    bool succeeded_ = false;
+};
+
+#endif // PYQUADRIFLOW_METRICS_H
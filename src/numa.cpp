@@ -0,0 +1,220 @@
+// NUMA topology from sysfs and mbind page placement behind numa.h.
+
+#include "numa.h"
+
+#include "hugepages.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+#endif
+
+#ifdef __linux__
+
+namespace {
+
+struct NumaNode {
+    int id;                 // kernel node id
+    std::vector<int> cpus;  // allowed CPUs on the node
+};
+
+// "0-3,8-11" -> {0, 1, 2, 3, 8, 9, 10, 11}
+std::vector<int> ParseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    size_t pos = 0;
+    while (pos < list.size()) {
+        size_t end = list.find(',', pos);
+        if (end == std::string::npos) end = list.size();
+        const std::string range = list.substr(pos, end - pos);
+        const size_t dash = range.find('-');
+        if (!range.empty() && range[0] >= '0' && range[0] <= '9') {
+            const int first = std::atoi(range.c_str());
+            const int last = dash == std::string::npos ? first : std::atoi(range.c_str() + dash + 1);
+            for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+        }
+        pos = end + 1;
+    }
+    return cpus;
+}
+
+std::vector<NumaNode> LoadTopology() {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    const bool have_affinity = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+    std::vector<NumaNode> nodes;
+    if (DIR* dir = opendir("/sys/devices/system/node")) {
+        while (dirent* entry = readdir(dir)) {
+            const std::string name = entry->d_name;
+            if (name.compare(0, 4, "node") != 0 || name.size() == 4 ||
+                name[4] < '0' || name[4] > '9') {
+                continue;
+            }
+            std::ifstream file("/sys/devices/system/node/" + name + "/cpulist");
+            std::string list;
+            std::getline(file, list);
+
+            NumaNode node;
+            node.id = std::atoi(name.c_str() + 4);
+            for (int cpu : ParseCpuList(list)) {
+                if (cpu < CPU_SETSIZE && (!have_affinity || CPU_ISSET(cpu, &allowed))) {
+                    node.cpus.push_back(cpu);
+                }
+            }
+            if (!node.cpus.empty()) nodes.push_back(node);
+        }
+        closedir(dir);
+    }
+    // readdir order is arbitrary
+    std::sort(nodes.begin(), nodes.end(),
+              [](const NumaNode& a, const NumaNode& b) { return a.id < b.id; });
+    return nodes;
+}
+
+const std::vector<NumaNode>& Topology() {
+    static const std::vector<NumaNode> nodes = LoadTopology();
+    return nodes;
+}
+
+// Set `policy` over the nodes `node_ids` (kernel ids) for [begin, end) and
+// move the pages already there. Only non-strict policies are used: with
+// MPOL_BIND a full node would fail allocations instead of spilling over.
+void SetPagePolicy(uintptr_t begin, uintptr_t end, int policy, const std::vector<int>& node_ids) {
+    if (end <= begin) return;
+    unsigned long mask[1024 / (8 * sizeof(unsigned long))] = {};
+    for (int id : node_ids) {
+        if (id < 0 || id >= 1024) return;
+        mask[id / (8 * sizeof(unsigned long))] |= 1UL << (id % (8 * sizeof(unsigned long)));
+    }
+    // Best effort: without CAP_SYS_NICE shared pages are not moved, and a
+    // refusal only leaves the pages where they are
+    syscall(SYS_mbind, reinterpret_cast<void*>(begin), end - begin, policy,
+            mask, sizeof(mask) * 8, MPOL_MF_MOVE);
+}
+
+// Whole pages of [data, data + bytes)
+void PageRange(void* data, size_t bytes, uintptr_t& first, uintptr_t& last) {
+    const uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+    const uintptr_t start = reinterpret_cast<uintptr_t>(data);
+    first = (start + page - 1) & ~(page - 1);
+    last = (start + bytes) & ~(page - 1);
+}
+
+} // namespace
+
+int NumaNodeCount() {
+    const int count = (int)Topology().size();
+    return count > 0 ? count : 1;
+}
+
+int NumaNodeCpuCount(int node) {
+    const auto& nodes = Topology();
+    if (node < 0 || node >= (int)nodes.size()) return 0;
+    return (int)nodes[node].cpus.size();
+}
+
+int NumaCpuCount() {
+    int count = 0;
+    for (const NumaNode& node : Topology()) count += (int)node.cpus.size();
+    if (count == 0) {
+        // No sysfs node directory (some containers): the mask alone
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) count = CPU_COUNT(&allowed);
+    }
+    if (count == 0) count = (int)std::thread::hardware_concurrency();
+    return std::max(count, 1);
+}
+
+bool NumaBindThread(int node, int cpu) {
+    const auto& nodes = Topology();
+    if (node < 0 || node >= (int)nodes.size()) return false;
+    if (nodes.size() < 2 && cpu < 0) return false;
+    const std::vector<int>& cpus = nodes[node].cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (cpu >= 0) {
+        CPU_SET(cpus[cpu % cpus.size()], &set);
+    } else {
+        for (int c : cpus) CPU_SET(c, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+void NumaPartitionPages(void* data, size_t bytes) {
+    const auto& nodes = Topology();
+    if (nodes.size() < 2 || bytes < kHugePageThreshold) return;
+
+    const uintptr_t start = reinterpret_cast<uintptr_t>(data);
+    uintptr_t first, last;
+    PageRange(data, bytes, first, last);
+    const size_t k = nodes.size();
+
+    uintptr_t begin = first;
+    for (size_t node = 0; node < k; ++node) {
+        uintptr_t end = last;
+        if (node + 1 < k) {
+            const uintptr_t split = start + (uintptr_t)((double)bytes * (node + 1) / k);
+            end = (split + kHugePageSize - 1) & ~(uintptr_t)(kHugePageSize - 1);
+            if (end > last) end = last;
+        }
+        SetPagePolicy(begin, end, MPOL_PREFERRED, {nodes[node].id});
+        if (end > begin) begin = end;
+    }
+}
+
+void NumaInterleavePages(void* data, size_t bytes) {
+    const auto& nodes = Topology();
+    if (nodes.size() < 2 || bytes < kHugePageThreshold) return;
+
+    uintptr_t first, last;
+    PageRange(data, bytes, first, last);
+    std::vector<int> ids;
+    for (const NumaNode& node : nodes) ids.push_back(node.id);
+    SetPagePolicy(first, last, MPOL_INTERLEAVE, ids);
+}
+
+#endif
+
+int NumaHomeNode(int64_t index, int64_t count) {
+    const int nodes = NumaNodeCount();
+    if (nodes < 2 || count <= 0) return 0;
+    return (int)std::min<int64_t>(nodes - 1, index * nodes / count);
+}
+
+#ifndef __linux__
+
+int NumaNodeCount() {
+    return 1;
+}
+
+int NumaNodeCpuCount(int) {
+    return 0;
+}
+
+int NumaCpuCount() {
+    return std::max(1, (int)std::thread::hardware_concurrency());
+}
+
+bool NumaBindThread(int, int) {
+    return false;
+}
+
+void NumaPartitionPages(void*, size_t) {}
+
+void NumaInterleavePages(void*, size_t) {}
+
+#endif
@@ -0,0 +1,46 @@
+// NUMA topology, thread pinning and page placement (Linux).
+// Pure C++ — no QuadriFlow headers.
+//
+// The topology comes from sysfs and pages are placed with the mbind system
+// call, so there is no libnuma dependency. Only nodes with CPUs this process
+// may run on count. On single-node machines and other platforms there is one
+// node and pinning / placement do nothing.
+
+#ifndef PYQUADRIFLOW_NUMA_H
+#define PYQUADRIFLOW_NUMA_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Usable nodes, indexed 0 .. NumaNodeCount() - 1 (not kernel node ids).
+int NumaNodeCount();
+
+// Restrict the calling thread to the CPUs of `node` that the process may
+// use, or with cpu >= 0 to just the (cpu mod count)-th of them. Returns
+// false if it stays unpinned (a single node and no cpu given included).
+bool NumaBindThread(int node, int cpu = -1);
+
+// Number of the process's CPUs on `node`.
+int NumaNodeCpuCount(int node);
+
+// Number of CPUs this process may run on (its affinity mask, so taskset
+// and cgroup cpusets count), at least 1.
+int NumaCpuCount();
+
+// Split the whole pages of [data, data + bytes) into NumaNodeCount()
+// contiguous blocks of near-equal size and move block k to node k, with
+// block boundaries on 2 MB so huge pages stay whole. A vertex-indexed array
+// thus has the k-th range of vertices on node k, the range NumaHomeNode
+// gives its vertices. Small buffers are skipped. The placement is a
+// preference: a full node spills to the others instead of failing.
+void NumaPartitionPages(void* data, size_t bytes);
+
+// Spread the whole pages of [data, data + bytes) round-robin over all
+// nodes, for data every node reads alike. Small buffers are skipped.
+void NumaInterleavePages(void* data, size_t bytes);
+
+// Node whose NumaPartitionPages block holds element `index` of `count`
+// elements (up to the 2 MB rounding of the block boundaries).
+int NumaHomeNode(int64_t index, int64_t count);
+
+#endif // PYQUADRIFLOW_NUMA_H
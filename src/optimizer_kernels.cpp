@@ -0,0 +1,629 @@
+// Flag-specialized optimizer kernels.
+// Numerically identical to qflow::Optimizer (same operation order, same
+// float-precision constraint weights), minus the per-element flag tests.
+
+#include "optimizer_kernels.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "numa.h"
+#include "pipeline.h"
+#include "progress.h"
+#include "thread_pool.h"
+#include "trace.h"
+
+#ifdef _WIN32
+#define _USE_MATH_DEFINES
+#include <math.h>
+#endif
+
+#include "config.hpp"
+#include "field-math.hpp"
+
+using namespace qflow;
+
+namespace {
+
+using Phases = std::vector<std::vector<int>>;
+
+int LevelIterations(const SolverSchedule& schedule, int level) {
+    if (level < schedule.finest_level) return 0;
+    if (schedule.coarsest_level >= 0 && level > schedule.coarsest_level) return 0;
+    return schedule.iterations;
+}
+
+// Finest level a solve visits
+int LastLevel(const SolverSchedule& schedule) {
+    return schedule.stop_at_finest ? std::max(schedule.finest_level, 0) : 0;
+}
+
+// Coarsest level a solve visits, of num_levels
+int FirstLevel(const SolverSchedule& schedule, int num_levels) {
+    if (schedule.start_level < 0) return num_levels - 1;
+    return std::min(schedule.start_level, num_levels - 1);
+}
+
+// ---------------------------------------------------------------------------
+// Domain decomposition
+// ---------------------------------------------------------------------------
+
+// Vertices per block. Fixed rather than derived from the thread count, so
+// the blocks, and with them the result, are the same on every machine.
+const int kDomainBlockVertices = 4096;
+
+struct Domains {
+    std::vector<int> block_of;              // block of every vertex
+    std::vector<std::vector<int>> blocks;   // vertices of each block, in phase order
+    std::vector<int> home_vertex;           // median vertex index of each block
+    std::vector<int> halo;                  // vertices read by another block
+};
+
+// Interleave the low 21 bits of x with two zero bits each
+uint64_t SpreadBits(uint64_t x) {
+    x &= 0x1fffff;
+    x = (x | x << 32) & 0x1f00000000ffffull;
+    x = (x | x << 16) & 0x1f0000ff0000ffull;
+    x = (x | x << 8)  & 0x100f00f00f00f00full;
+    x = (x | x << 4)  & 0x10c30c30c30c30c3ull;
+    x = (x | x << 2)  & 0x1249249249249249ull;
+    return x;
+}
+
+// Cut a level into spatially compact blocks: runs of kDomainBlockVertices
+// vertices along the Morton curve of their positions. Levels too small for
+// two blocks get none and are swept serially.
+Domains PartitionLevel(const AdjacentMatrix& adj, const MatrixXd& V, const Phases& phases) {
+    Domains d;
+    const int n = (int)V.cols();
+    if (n < 2 * kDomainBlockVertices) return d;
+
+    const Vector3d lo = V.rowwise().minCoeff(), hi = V.rowwise().maxCoeff();
+    const Vector3d extent = (hi - lo).cwiseMax(RCPOVERFLOW);
+    std::vector<std::pair<uint64_t, int>> order(n);
+    for (int i = 0; i < n; ++i) {
+        uint64_t key = 0;
+        for (int k = 0; k < 3; ++k) {
+            const double t = (V(k, i) - lo[k]) / extent[k];
+            key |= SpreadBits((uint64_t)(t * 0x1fffff)) << k;
+        }
+        order[i] = {key, i};
+    }
+    std::sort(order.begin(), order.end());
+
+    const int num_blocks = (n + kDomainBlockVertices - 1) / kDomainBlockVertices;
+    d.block_of.resize(n);
+    for (int rank = 0; rank < n; ++rank) {
+        d.block_of[order[rank].second] = rank / kDomainBlockVertices;
+    }
+    d.blocks.resize(num_blocks);
+    for (const auto& p : phases) {
+        for (int i : p) d.blocks[d.block_of[i]].push_back(i);
+    }
+    d.home_vertex.resize(num_blocks);
+    for (int b = 0; b < num_blocks; ++b) {
+        std::vector<int> ids = d.blocks[b];
+        std::nth_element(ids.begin(), ids.begin() + ids.size() / 2, ids.end());
+        d.home_vertex[b] = ids[ids.size() / 2];
+    }
+
+    std::vector<char> is_halo(n, 0);
+    for (int i = 0; i < n; ++i) {
+        for (const auto& link : adj[i]) {
+            if (d.block_of[link.id] != d.block_of[i]) is_halo[link.id] = 1;
+        }
+    }
+    for (int i = 0; i < n; ++i) {
+        if (is_halo[i]) d.halo.push_back(i);
+    }
+    return d;
+}
+
+// ---------------------------------------------------------------------------
+// Parallel phases
+// ---------------------------------------------------------------------------
+
+// Phases at least kParallelPhaseVertices large are swept in parallel, in
+// chunks of kPhaseChunk vertices
+const int kPhaseChunk = 1024;
+
+// True if no vertex links to another vertex of its own phase. Each phase
+// then only reads vertices it does not write, so sweeping it in parallel
+// gives exactly the serial result.
+bool PhasesIndependent(const AdjacentMatrix& adj, const Phases& phases) {
+    std::vector<int> phase_of(adj.size(), -1);
+    for (size_t phase = 0; phase < phases.size(); ++phase) {
+        for (int i : phases[phase]) phase_of[i] = (int)phase;
+    }
+    for (size_t i = 0; i < adj.size(); ++i) {
+        for (const auto& link : adj[i]) {
+            if (link.id != (int)i && phase_of[link.id] == phase_of[i]) return false;
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Field access
+// ---------------------------------------------------------------------------
+// The vertex updates read (own vertex and neighbours) and write the field
+// they smooth only through one of these.
+
+// Plain reads and writes: serial and independent-phase sweeps
+struct DirectAccess {
+    MatrixXd& field;
+
+    Vector3d read(int j) const { return field.col(j); }
+    void write(int i, const Vector3d& value) const { field.col(i) = value; }
+};
+
+// Domain decomposition: vertices of other blocks come from the halo copy
+struct HaloAccess {
+    MatrixXd& field;
+    const MatrixXd& halo;
+    const std::vector<int>& block_of;
+    int block;
+
+    Vector3d read(int j) const {
+        if (block_of[j] == block) return field.col(j);
+        return halo.col(j);
+    }
+    void write(int i, const Vector3d& value) const { field.col(i) = value; }
+};
+
+// Chaotic relaxation: every coefficient may be written by one thread while
+// others read it, so each is loaded and stored atomically (relaxed). A
+// column can mix coefficients of two updates; the sweeps tolerate that.
+inline double RelaxedLoad(const double* p) {
+#if defined(__GNUC__) || defined(__clang__)
+    double value;
+    __atomic_load(p, &value, __ATOMIC_RELAXED);
+    return value;
+#else
+    return *(const volatile double*)p;  // aligned 8-byte access is atomic on MSVC targets
+#endif
+}
+
+inline void RelaxedStore(double* p, double value) {
+#if defined(__GNUC__) || defined(__clang__)
+    __atomic_store(p, &value, __ATOMIC_RELAXED);
+#else
+    *(volatile double*)p = value;
+#endif
+}
+
+struct RelaxedAccess {
+    double* data;   // 3 x N, column-major
+
+    Vector3d read(int j) const {
+        const double* p = data + 3 * (size_t)j;
+        return Vector3d(RelaxedLoad(p), RelaxedLoad(p + 1), RelaxedLoad(p + 2));
+    }
+    void write(int i, const Vector3d& value) const {
+        double* p = data + 3 * (size_t)i;
+        RelaxedStore(p, value[0]);
+        RelaxedStore(p + 1, value[1]);
+        RelaxedStore(p + 2, value[2]);
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Level sweeps
+// ---------------------------------------------------------------------------
+
+// body(i) for every work item i in [0, n) on the executor. With the
+// built-in pool on a NUMA machine, item i is owned by the node holding
+// vertex vertex_of(i) of the level's num_vertices (the pipeline partitions
+// the hierarchy by vertex index), so the sweeps mostly touch local memory.
+template <typename VertexOf, typename Body>
+void ParallelItems(int n, int num_vertices, const VertexOf& vertex_of, const Body& body) {
+    const std::shared_ptr<QuadriFlowExecutor> executor = get_executor();
+    if (NumaNodeCount() > 1 && executor == default_executor()) {
+        ThreadPoolParallelForHome(
+            n, [&](int i) { return NumaHomeNode(vertex_of(i), num_vertices); }, body);
+        return;
+    }
+    executor->parallel_for(n, body);
+}
+
+// Vertices per work item of a chaotic sweep
+const int kChaoticChunk = 1024;
+
+// How one level is swept
+struct LevelSweep {
+    Domains domains;               // blocks: domain decomposition
+    bool parallel_phases = false;  // split large independent phases
+    bool chaotic = false;          // chaotic relaxation
+};
+
+LevelSweep PlanLevelSweep(
+    const Hierarchy& mRes, int level, const SolverSchedule& schedule, int iterations
+) {
+    LevelSweep sweep;
+    if (iterations == 0) return sweep;
+    if (schedule.chaotic_relaxation) {
+        sweep.chaotic = true;
+        return sweep;
+    }
+    if (schedule.domain_decomposition) {
+        TraceScope trace("partition", level);
+        sweep.domains = PartitionLevel(mRes.mAdj[level], mRes.mV[level], mRes.mPhases[level]);
+        if (!sweep.domains.blocks.empty()) return sweep;
+    }
+    if (get_executor()->concurrency() > 1) {
+        const Phases& phases = mRes.mPhases[level];
+        const bool large = std::any_of(phases.begin(), phases.end(), [](const std::vector<int>& p) {
+            return (int)p.size() >= kParallelPhaseVertices;
+        });
+        sweep.parallel_phases = large && PhasesIndependent(mRes.mAdj[level], phases);
+    }
+    return sweep;
+}
+
+// Run `iterations` sweeps of update(i, access) over a level, where the
+// update smooths vertex i of `field`, reading and writing it via `access`.
+//
+// By default this is the Gauss-Seidel sweep, phase by phase, with the large
+// phases split over the executor when `parallel_phases`.
+//
+// With blocks the sweeps are additive Schwarz: the blocks are swept in
+// parallel, Gauss-Seidel inside each, and read the vertices of other blocks
+// from a halo copy refreshed once per iteration. No colour barriers, one
+// join per iteration, and the result does not depend on the thread count.
+//
+// Chaotic relaxation drops the phases and every join but the last: all
+// iterations of all chunks of vertices (in index order) are one parallel
+// loop, and threads read whatever their neighbours hold at the time.
+// Fastest, but the result depends on the timing of the threads.
+template <typename Update>
+void SweepLevel(
+    const char* sweep_name, const char* block_name, const Phases& phases,
+    const LevelSweep& sweep, MatrixXd& field, int iterations, const Update& update
+) {
+    if (iterations == 0) return;
+
+    if (sweep.chaotic) {
+        TraceScope trace(sweep_name);
+        const RelaxedAccess access{field.data()};
+        const int n = (int)field.cols();
+        const int chunks = (n + kChaoticChunk - 1) / kChaoticChunk;
+        // Items are claimed in order, so the iterations of a chunk still run
+        // roughly one after another
+        const auto first_vertex = [&](int item) { return item % chunks * kChaoticChunk; };
+        ParallelItems(iterations * chunks, n, first_vertex, [&](int item) {
+            const int chunk = item % chunks;
+            TraceScope trace(block_name, chunk);
+            const int end = std::min(n, (chunk + 1) * kChaoticChunk);
+            for (int i = chunk * kChaoticChunk; i < end; ++i) update(i, access);
+        });
+        return;
+    }
+
+    if (!sweep.domains.blocks.empty()) {
+        const Domains& domains = sweep.domains;
+        const int n = (int)field.cols();
+        const auto home_vertex = [&](int b) { return domains.home_vertex[b]; };
+        MatrixXd halo(field.rows(), field.cols());
+        for (int iter = 0; iter < iterations; ++iter) {
+            TraceScope trace(sweep_name, iter);
+            for (int j : domains.halo) halo.col(j) = field.col(j);
+
+            ParallelItems((int)domains.blocks.size(), n, home_vertex, [&](int b) {
+                TraceScope trace(block_name, b);
+                const HaloAccess access{field, halo, domains.block_of, b};
+                for (int i : domains.blocks[b]) update(i, access);
+            });
+        }
+        return;
+    }
+
+    const DirectAccess access{field};
+    const int n = (int)field.cols();
+    for (int iter = 0; iter < iterations; ++iter) {
+        for (size_t phase = 0; phase < phases.size(); ++phase) {
+            TraceScope trace(sweep_name, (int)phase);
+            const std::vector<int>& p = phases[phase];
+            if (!sweep.parallel_phases || (int)p.size() < kParallelPhaseVertices) {
+                for (int i : p) update(i, access);
+                continue;
+            }
+            const int size = (int)p.size();
+            const auto first_vertex = [&](int c) { return p[c * kPhaseChunk]; };
+            ParallelItems((size + kPhaseChunk - 1) / kPhaseChunk, n, first_vertex, [&](int c) {
+                const int end = std::min(size, (c + 1) * kPhaseChunk);
+                for (int k = c * kPhaseChunk; k < end; ++k) update(p[k], access);
+            });
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Orientation field
+// ---------------------------------------------------------------------------
+template <bool Constrained, typename Access>
+inline void SmoothOrientationVertex(
+    int i, const AdjacentMatrix& adj, const MatrixXd& N,
+    const MatrixXd& CQ, const VectorXd& CQw, const Access& Q
+) {
+    const Vector3d n_i = N.col(i);
+    double weight_sum = 0.0;
+    Vector3d sum = Q.read(i);
+    for (const auto& link : adj[i]) {
+        const int j = link.id;
+        const double weight = link.weight;
+        if (weight == 0) continue;
+        const Vector3d n_j = N.col(j);
+        Vector3d q_j = Q.read(j);
+        std::pair<Vector3d, Vector3d> value =
+            compat_orientation_extrinsic_4(sum, n_i, q_j, n_j);
+        sum = value.first * weight_sum + value.second * weight;
+        sum -= n_i * n_i.dot(sum);
+        weight_sum += weight;
+        double norm = sum.norm();
+        if (norm > RCPOVERFLOW) sum /= norm;
+    }
+
+    if (Constrained) {
+        float cw = CQw[i];
+        if (cw != 0) {
+            std::pair<Vector3d, Vector3d> value =
+                compat_orientation_extrinsic_4(sum, n_i, CQ.col(i), n_i);
+            sum = value.first * (1 - cw) + value.second * cw;
+            sum -= n_i * n_i.dot(sum);
+
+            float norm = sum.norm();
+            if (norm > RCPOVERFLOW) sum /= norm;
+        }
+    }
+
+    if (weight_sum > 0) {
+        Q.write(i, sum);
+    }
+}
+
+template <bool Constrained>
+void SmoothOrientationLevel(
+    const AdjacentMatrix& adj, const MatrixXd& N,
+    const MatrixXd& CQ, const VectorXd& CQw,
+    const Phases& phases, const LevelSweep& sweep, MatrixXd& Q, int iterations
+) {
+    SweepLevel("orientations.sweep", "orientations.block", phases, sweep, Q, iterations,
+               [&](int i, const auto& access) {
+                   SmoothOrientationVertex<Constrained>(i, adj, N, CQ, CQw, access);
+               });
+}
+
+template <bool Constrained>
+void OptimizeOrientationsImpl(
+    const Hierarchy& mRes, std::vector<MatrixXd>& mQ, const SolverSchedule& schedule
+) {
+    const int last = LastLevel(schedule);
+    for (int level = FirstLevel(schedule, (int)mRes.mN.size()); level >= last; --level) {
+        ProgressCheckpoint();
+        TraceScope trace("orientations.level", level);
+        const int iterations = LevelIterations(schedule, level);
+        SmoothOrientationLevel<Constrained>(
+            mRes.mAdj[level], mRes.mN[level], mRes.mCQ[level], mRes.mCQw[level],
+            mRes.mPhases[level], PlanLevelSweep(mRes, level, schedule, iterations),
+            mQ[level], iterations);
+
+        if (level > last) {
+            const MatrixXd& srcField = mQ[level];
+            const MatrixXi& toUpper = mRes.mToUpper[level - 1];
+            MatrixXd& destField = mQ[level - 1];
+            const MatrixXd& N = mRes.mN[level - 1];
+            for (int i = 0; i < srcField.cols(); ++i) {
+                const Vector3d q = srcField.col(i);
+                for (int k = 0; k < 2; ++k) {
+                    int dest = toUpper(k, i);
+                    if (dest == -1) continue;
+                    Vector3d n = N.col(dest);
+                    destField.col(dest) = q - n * n.dot(q);
+                }
+            }
+        }
+    }
+
+    // Restrict the converged fine field back onto the coarse levels
+    TraceScope trace("orientations.restrict");
+    for (int l = last; l < (int)mRes.mN.size() - 1; ++l) {
+        const MatrixXd& N = mRes.mN[l];
+        const MatrixXd& N_next = mRes.mN[l + 1];
+        const MatrixXd& Q = mQ[l];
+        MatrixXd& Q_next = mQ[l + 1];
+        const MatrixXi& toUpper = mRes.mToUpper[l];
+        for (int i = 0; i < toUpper.cols(); ++i) {
+            Vector2i upper = toUpper.col(i);
+            Vector3d q0 = Q.col(upper[0]);
+            Vector3d n0 = N.col(upper[0]);
+            Vector3d q;
+
+            if (upper[1] != -1) {
+                Vector3d q1 = Q.col(upper[1]);
+                Vector3d n1 = N.col(upper[1]);
+                auto result = compat_orientation_extrinsic_4(q0, n0, q1, n1);
+                q = result.first + result.second;
+            } else {
+                q = q0;
+            }
+            Vector3d n = N_next.col(i);
+            q -= n.dot(q) * n;
+            if (q.squaredNorm() > RCPOVERFLOW) q.normalize();
+
+            Q_next.col(i) = q;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Position field
+// ---------------------------------------------------------------------------
+template <bool WithScale, bool Constrained, typename Access>
+inline void SmoothPositionVertex(
+    int i, const AdjacentMatrix& adj,
+    const MatrixXd& N, const MatrixXd& Q, const MatrixXd& V, const MatrixXd& S,
+    const MatrixXd& CQ, const MatrixXd& CO, const VectorXd& COw,
+    double scale, double inv_scale, const Access& O
+) {
+    double scale_x = scale, scale_y = scale;
+    double inv_scale_x = inv_scale, inv_scale_y = inv_scale;
+    if (WithScale) {
+        scale_x *= S(0, i);
+        scale_y *= S(1, i);
+        inv_scale_x = 1.0f / scale_x;
+        inv_scale_y = 1.0f / scale_y;
+    }
+    const Vector3d n_i = N.col(i), v_i = V.col(i);
+    Vector3d q_i = Q.col(i);
+
+    Vector3d sum = O.read(i);
+    double weight_sum = 0.0;
+
+    q_i.normalize();
+    for (const auto& link : adj[i]) {
+        const int j = link.id;
+        const double weight = link.weight;
+        if (weight == 0) continue;
+        double scale_x_1 = scale, scale_y_1 = scale;
+        double inv_scale_x_1 = inv_scale, inv_scale_y_1 = inv_scale;
+        if (WithScale) {
+            scale_x_1 *= S(0, j);
+            scale_y_1 *= S(1, j);
+            inv_scale_x_1 = 1.0f / scale_x_1;
+            inv_scale_y_1 = 1.0f / scale_y_1;
+        }
+
+        const Vector3d n_j = N.col(j), v_j = V.col(j);
+        Vector3d q_j = Q.col(j), o_j = O.read(j);
+
+        q_j.normalize();
+
+        std::pair<Vector3d, Vector3d> value = compat_position_extrinsic_4(
+            v_i, n_i, q_i, sum, v_j, n_j, q_j, o_j, scale_x, scale_y, inv_scale_x,
+            inv_scale_y, scale_x_1, scale_y_1, inv_scale_x_1, inv_scale_y_1);
+
+        sum = value.first * weight_sum + value.second * weight;
+        weight_sum += weight;
+        if (weight_sum > RCPOVERFLOW) sum /= weight_sum;
+        sum -= n_i.dot(sum - v_i) * n_i;
+    }
+
+    if (Constrained) {
+        float cw = COw[i];
+        if (cw != 0) {
+            Vector3d co = CO.col(i), cq = CQ.col(i);
+            Vector3d d = co - sum;
+            d -= cq.dot(d) * cq;
+            sum += cw * d;
+            sum -= n_i.dot(sum - v_i) * n_i;
+        }
+    }
+
+    if (weight_sum > 0) {
+        O.write(i, position_round_4(sum, q_i, n_i, v_i, scale_x, scale_y,
+                                    inv_scale_x, inv_scale_y));
+    }
+}
+
+template <bool WithScale, bool Constrained>
+void SmoothPositionLevel(
+    const AdjacentMatrix& adj,
+    const MatrixXd& N, const MatrixXd& Q, const MatrixXd& V, const MatrixXd& S,
+    const MatrixXd& CQ, const MatrixXd& CO, const VectorXd& COw,
+    const Phases& phases, const LevelSweep& sweep, double scale, MatrixXd& O, int iterations
+) {
+    // Uniform-scale path: the lattice spacing is the same for every vertex
+    const double inv_scale = 1.0f / scale;
+
+    SweepLevel("positions.sweep", "positions.block", phases, sweep, O, iterations,
+               [&](int i, const auto& access) {
+                   SmoothPositionVertex<WithScale, Constrained>(
+                       i, adj, N, Q, V, S, CQ, CO, COw, scale, inv_scale, access);
+               });
+}
+
+template <bool WithScale, bool Constrained>
+void OptimizePositionsImpl(Hierarchy& mRes, const SolverSchedule& schedule) {
+    const int last = LastLevel(schedule);
+    for (int level = FirstLevel(schedule, (int)mRes.mAdj.size()); level >= last; --level) {
+        ProgressCheckpoint();
+        TraceScope trace("positions.level", level);
+        const int iterations = LevelIterations(schedule, level);
+        SmoothPositionLevel<WithScale, Constrained>(
+            mRes.mAdj[level], mRes.mN[level], mRes.mQ[level], mRes.mV[level], mRes.mS[level],
+            mRes.mCQ[level], mRes.mCO[level], mRes.mCOw[level],
+            mRes.mPhases[level], PlanLevelSweep(mRes, level, schedule, iterations),
+            mRes.mScale, mRes.mO[level], iterations);
+
+        if (level > last) {
+            const MatrixXd& srcField = mRes.mO[level];
+            const MatrixXi& toUpper = mRes.mToUpper[level - 1];
+            MatrixXd& destField = mRes.mO[level - 1];
+            const MatrixXd& N = mRes.mN[level - 1];
+            const MatrixXd& V = mRes.mV[level - 1];
+            for (int i = 0; i < srcField.cols(); ++i) {
+                for (int k = 0; k < 2; ++k) {
+                    int dest = toUpper(k, i);
+                    if (dest == -1) continue;
+                    Vector3d o = srcField.col(i), n = N.col(dest), v = V.col(dest);
+                    o -= n * n.dot(o - v);
+                    destField.col(dest) = o;
+                }
+            }
+        }
+    }
+}
+
+bool AnyNonZero(const std::vector<VectorXd>& weights) {
+    for (const auto& w : weights) {
+        for (Eigen::Index i = 0; i < w.size(); ++i) {
+            if ((float)w[i] != 0) return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Dispatch — flags are resolved once per call, never inside the sweeps
+// ---------------------------------------------------------------------------
+double ScheduleCost(const Hierarchy& mRes, const SolverSchedule& schedule) {
+    const SolverSchedule full;
+    double done = 0, total = 0;
+    for (int level = 0; level < (int)mRes.mV.size(); ++level) {
+        const double n = (double)mRes.mV[level].cols();
+        done += n * LevelIterations(schedule, level);
+        total += n * LevelIterations(full, level);
+    }
+    return total > 0 ? done / total : 0.0;
+}
+
+void OptimizeOrientations(Hierarchy& mRes, const SolverSchedule& schedule) {
+    OptimizeOrientations(mRes, mRes.mQ, schedule);
+}
+
+void OptimizeOrientations(
+    const Hierarchy& mRes, std::vector<MatrixXd>& Q, const SolverSchedule& schedule
+) {
+    if (AnyNonZero(mRes.mCQw)) {
+        OptimizeOrientationsImpl<true>(mRes, Q, schedule);
+    } else {
+        OptimizeOrientationsImpl<false>(mRes, Q, schedule);
+    }
+}
+
+void OptimizePositions(Hierarchy& mRes, int with_scale, const SolverSchedule& schedule) {
+    // The pipeline passes with_scale = 1 on every run
+    const bool constrained = AnyNonZero(mRes.mCOw);
+    if (with_scale) {
+        if (constrained) OptimizePositionsImpl<true, true>(mRes, schedule);
+        else             OptimizePositionsImpl<true, false>(mRes, schedule);
+    } else {
+        if (constrained) OptimizePositionsImpl<false, true>(mRes, schedule);
+        else             OptimizePositionsImpl<false, false>(mRes, schedule);
+    }
+}
@@ -0,0 +1,71 @@
+// Flag-specialized optimizer kernels for the QuadriFlow pipeline.
+// Includes QuadriFlow headers — only pipeline-side translation units may
+// include this file (never _pyquadriflow.cpp).
+//
+// The upstream Optimizer re-tests `with_scale` and the constraint weights
+// for every vertex and every neighbour of every sweep. The kernels here are
+// instantiated once per flag combination and selected a single time per
+// call, so the unconstrained paths are branch-free. The pipeline always
+// solves positions with the scale field (like upstream, it sets
+// flag_adaptive_scale before OptimizePositions); the uniform-scale
+// instantiations serve direct callers and the benchmark only.
+//
+// Large phases are split over the executor. A phase is an independent set
+// of the level's graph (checked per call), so this equals the serial sweep.
+
+#ifndef PYQUADRIFLOW_OPTIMIZER_KERNELS_H
+#define PYQUADRIFLOW_OPTIMIZER_KERNELS_H
+
+#include <vector>
+
+#include "hierarchy.hpp"
+
+// Smallest phase split over the executor. Levels below it are swept on the
+// calling thread (chaotic sweeps of a few chunks aside), so there is no
+// per-node work to place their data for.
+const int kParallelPhaseVertices = 4096;
+
+// Coarse-to-fine smoothing schedule. The default matches upstream.
+struct SolverSchedule {
+    int iterations = 6;     // smoothing sweeps per hierarchy level
+    int finest_level = 0;   // levels below this only receive prolongation
+    int coarsest_level = -1; // levels above this are kept as-is (-1: none)
+    // Level the solve starts from (-1: the coarsest). Its field, already
+    // solved, is prolonged down instead of the coarser ones; the levels
+    // above it are left untouched until the final restriction.
+    int start_level = -1;
+    // Stop at finest_level instead of prolonging down to level 0; the finer
+    // levels are left untouched (previews read finest_level directly)
+    bool stop_at_finest = false;
+    // Sweep each level as spatially compact vertex blocks in parallel,
+    // exchanging halo values between iterations, instead of serially colour
+    // by colour. Converges slightly slower per iteration; levels too small
+    // to split are swept serially.
+    bool domain_decomposition = false;
+    // Chaotic (Hogwild) relaxation: threads sweep chunks of vertices with no
+    // phases and no barrier between iterations, reading neighbours as they
+    // are. Highest throughput, but not deterministic; overrides
+    // domain_decomposition.
+    bool chaotic_relaxation = false;
+};
+
+// Fraction of the default schedule's smoothing work that `schedule` does,
+// weighted by the vertex count of each level.
+double ScheduleCost(const qflow::Hierarchy& mRes, const SolverSchedule& schedule);
+
+// Drop-in replacement for Optimizer::optimize_orientations.
+void OptimizeOrientations(qflow::Hierarchy& mRes,
+                          const SolverSchedule& schedule = SolverSchedule());
+
+// Same, on caller-owned per-level orientation fields `Q` (one 3xN matrix per
+// hierarchy level) instead of mRes.mQ; mRes is only read. Lets several
+// candidate fields share one hierarchy.
+void OptimizeOrientations(const qflow::Hierarchy& mRes,
+                          std::vector<Eigen::MatrixXd>& Q,
+                          const SolverSchedule& schedule = SolverSchedule());
+
+// Drop-in replacement for Optimizer::optimize_positions.
+void OptimizePositions(qflow::Hierarchy& mRes, int with_scale,
+                       const SolverSchedule& schedule = SolverSchedule());
+
+#endif // PYQUADRIFLOW_OPTIMIZER_KERNELS_H
@@ -0,0 +1,120 @@
+// Per-thread perf event counters behind PerfCounterScope.
+
+#include "perf_counters.h"
+
+#include "pipeline.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#endif
+
+std::atomic<bool> g_perf_counters_enabled{false};
+
+namespace {
+
+thread_local int64_t t_folded[PERF_NUM_COUNTERS] = {};
+
+} // namespace
+
+void PerfCountersFold(const int64_t delta[PERF_NUM_COUNTERS]) {
+    for (int i = 0; i < PERF_NUM_COUNTERS; ++i) {
+        if (delta[i] > 0) t_folded[i] += delta[i];
+    }
+}
+
+#ifdef __linux__
+
+namespace {
+
+struct EventConfig {
+    uint32_t type;
+    uint64_t config;
+};
+
+const EventConfig kEventConfigs[PERF_NUM_COUNTERS] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},  // last-level cache on x86 and most ARM PMUs
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+};
+
+// User-space only, so the default perf_event_paranoid level (2) allows it.
+int OpenCounter(const EventConfig& event) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = event.type;
+    attr.config = event.config;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+struct ThreadCounters {
+    int fd[PERF_NUM_COUNTERS];
+
+    ThreadCounters() {
+        for (int i = 0; i < PERF_NUM_COUNTERS; ++i) fd[i] = OpenCounter(kEventConfigs[i]);
+    }
+
+    ~ThreadCounters() {
+        for (int i = 0; i < PERF_NUM_COUNTERS; ++i) {
+            if (fd[i] >= 0) close(fd[i]);
+        }
+    }
+};
+
+int64_t ReadCounter(int fd) {
+    if (fd < 0) return -1;
+    uint64_t data[3];  // value, time enabled, time running
+    if (read(fd, data, sizeof(data)) != (ssize_t)sizeof(data)) return -1;
+    if (data[2] == 0) return 0;
+    if (data[2] == data[1]) return (int64_t)data[0];
+    // Multiplexed with other events: extrapolate over the enabled time
+    return (int64_t)((double)data[0] * (double)data[1] / (double)data[2]);
+}
+
+} // namespace
+
+void PerfCountersRead(int64_t values[PERF_NUM_COUNTERS]) {
+    static thread_local ThreadCounters counters;
+    for (int i = 0; i < PERF_NUM_COUNTERS; ++i) {
+        values[i] = ReadCounter(counters.fd[i]);
+        if (values[i] >= 0) values[i] += t_folded[i];
+    }
+}
+
+bool hardware_counters_available() {
+    const int fd = OpenCounter(kEventConfigs[PERF_CYCLES]);
+    if (fd < 0) return false;
+    close(fd);
+    return true;
+}
+
+#else
+
+void PerfCountersRead(int64_t values[PERF_NUM_COUNTERS]) {
+    for (int i = 0; i < PERF_NUM_COUNTERS; ++i) values[i] = -1;
+}
+
+bool hardware_counters_available() {
+    return false;
+}
+
+#endif
+
+void set_hardware_counters_enabled(bool enabled) {
+    g_perf_counters_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool hardware_counters_enabled() {
+    return g_perf_counters_enabled.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,61 @@
+// Hardware performance counters for pipeline stages (Linux perf events).
+// Pure C++ — no QuadriFlow headers.
+//
+// Counters are opened per thread on first use. Pool workers count their
+// share of a parallel section with their own scope and the caller folds the
+// sums in (PerfCountersFold); threads a stage spawns itself are covered by
+// `inherit` when they exit. Counters the kernel refuses (perf_event_paranoid, containers,
+// virtual machines without a PMU) read as -1; on other platforms all do.
+
+#ifndef PYQUADRIFLOW_PERF_COUNTERS_H
+#define PYQUADRIFLOW_PERF_COUNTERS_H
+
+#include <atomic>
+#include <cstdint>
+
+enum PerfCounter {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_LLC_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_DTLB_MISSES,
+    PERF_NUM_COUNTERS,
+};
+
+extern std::atomic<bool> g_perf_counters_enabled;
+
+inline bool PerfCountersEnabled() {
+    return g_perf_counters_enabled.load(std::memory_order_relaxed);
+}
+
+// Current values of the calling thread's counters, scaled for multiplexing,
+// plus what was folded into it; -1 for counters that could not be opened.
+void PerfCountersRead(int64_t values[PERF_NUM_COUNTERS]);
+
+// Add worker deltas (entries < 0 are skipped) to the calling thread's counts.
+void PerfCountersFold(const int64_t delta[PERF_NUM_COUNTERS]);
+
+// Counts between construction and Finish() while counters are enabled.
+class PerfCounterScope {
+public:
+    PerfCounterScope() {
+        if (PerfCountersEnabled()) {
+            active_ = true;
+            PerfCountersRead(start_);
+        }
+    }
+
+    void Finish(int64_t delta[PERF_NUM_COUNTERS]) {
+        int64_t end[PERF_NUM_COUNTERS];
+        if (active_) PerfCountersRead(end);
+        for (int i = 0; i < PERF_NUM_COUNTERS; ++i) {
+            delta[i] = active_ && start_[i] >= 0 && end[i] >= 0 ? end[i] - start_[i] : -1;
+        }
+    }
+
+private:
+    bool active_ = false;
+    int64_t start_[PERF_NUM_COUNTERS];
+};
+
+#endif // PYQUADRIFLOW_PERF_COUNTERS_H
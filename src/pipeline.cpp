@@ -3,8 +3,16 @@
 
 #include "pipeline.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <cstring>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -17,6 +25,20 @@
 #include "field-math.hpp"
 #include "optimizer.hpp"
 #include "parametrizer.hpp"
+#include "pcg32.h"
+
+#include "alloc_stats.h"
+#include "graph_coloring.h"
+#include "hugepages.h"
+#include "mesh_reorder.h"
+#include "metrics.h"
+#include "numa.h"
+#include "optimizer_kernels.h"
+#include "perf_counters.h"
+#include "preview_extract.h"
+#include "progress.h"
+#include "thread_pool.h"
+#include "trace.h"
 
 using namespace qflow;
 
@@ -25,9 +47,11 @@ using namespace qflow;
 // ---------------------------------------------------------------------------
 class Parametrizer2 : public Parametrizer {
 public:
+    bool balanced_coloring = false;   // recolour the hierarchy after Initialize
+
     void LoadFromArrays(
-        const double* verts, int n_verts,
-        const int* face_indices, int n_faces
+        const double* verts, int64_t n_verts,
+        const int* face_indices, int64_t n_faces
     ) {
         struct obj_vertex {
             uint32_t p = (uint32_t)-1;
@@ -53,17 +77,18 @@ public:
 
         using VertexMap = std::unordered_map<obj_vertex, uint32_t, obj_vertex_hash>;
 
-        std::vector<Vector3d> positions;
-        std::vector<uint32_t> indices;
-        std::vector<obj_vertex> vertices;
+        HugePageVector<Vector3d> positions;
+        HugePageVector<uint32_t> indices;
+        HugePageVector<obj_vertex> vertices;
         VertexMap vertexMap;
 
         positions.reserve(n_verts);
-        for (int i = 0; i < n_verts; ++i) {
+        for (int64_t i = 0; i < n_verts; ++i) {
             positions.emplace_back(verts[i * 3], verts[i * 3 + 1], verts[i * 3 + 2]);
         }
 
-        for (int i = 0; i < n_faces; ++i) {
+        indices.reserve((size_t)n_faces * 3);
+        for (int64_t i = 0; i < n_faces; ++i) {
             obj_vertex tri[3];
             tri[0] = obj_vertex(face_indices[i * 3]);
             tri[1] = obj_vertex(face_indices[i * 3 + 1]);
@@ -83,55 +108,284 @@ public:
         }
 
         F.resize(3, indices.size() / 3);
+        AdviseHugePages(F.data(), sizeof(uint32_t) * indices.size());
         std::memcpy(F.data(), indices.data(), sizeof(uint32_t) * indices.size());
 
         V.resize(3, vertices.size());
+        AdviseHugePages(V.data(), sizeof(double) * V.size());
         for (uint32_t i = 0; i < vertices.size(); ++i) {
             V.col(i) = positions.at(vertices[i].p);
         }
 
         NormalizeMesh();
     }
+
+    // Adopt geometry that is already deduplicated (QuadriFlowMeshBuilder).
+    // Each buffer is released as soon as it has been copied.
+    void LoadFromBuffers(HugePageVector<Vector3d>& positions, HugePageVector<uint32_t>& indices) {
+        F.resize(3, indices.size() / 3);
+        AdviseHugePages(F.data(), sizeof(uint32_t) * indices.size());
+        std::memcpy(F.data(), indices.data(), sizeof(uint32_t) * indices.size());
+        HugePageVector<uint32_t>().swap(indices);
+
+        V.resize(3, positions.size());
+        AdviseHugePages(V.data(), sizeof(double) * V.size());
+        for (size_t i = 0; i < positions.size(); ++i) {
+            V.col(i) = positions[i];
+        }
+        HugePageVector<Vector3d>().swap(positions);
+
+        NormalizeMesh();
+    }
 };
 
 // ---------------------------------------------------------------------------
-// Main pipeline
+// Stage timing and time budget
 // ---------------------------------------------------------------------------
-QuadriFlowResult run_quadriflow(
-    const double* vertices, int num_vertices,
-    const int* faces, int num_faces,
-    int target_faces,
-    int seed,
-    bool preserve_sharp,
-    bool preserve_boundary,
-    bool adaptive_scale,
-    bool aggressive_sat,
-    bool minimum_cost_flow
+using Clock = std::chrono::steady_clock;
+
+static double SecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Records the wall time of one pipeline stage into result.stages.
+class StageScope {
+public:
+    // Also reports the stage to the call's progress callback, which may
+    // cancel the call before the stage starts
+    StageScope(QuadriFlowResult& result, const char* name)
+        : result_(result), name_(name), start_(Clock::now()), trace_(name) {
+        ProgressStage(name);
+    }
+
+    ~StageScope() {
+        const double seconds = SecondsSince(start_);
+        const AllocationCounters delta = allocations_.Finish();
+        QuadriFlowStageTiming timing;
+        timing.name = name_;
+        timing.seconds = seconds;
+        timing.allocations = delta.allocations;
+        timing.frees = delta.frees;
+        timing.bytes_allocated = delta.bytes_allocated;
+        timing.peak_bytes = delta.peak_bytes;
+        int64_t counters[PERF_NUM_COUNTERS];
+        counters_.Finish(counters);
+        timing.cycles = counters[PERF_CYCLES];
+        timing.instructions = counters[PERF_INSTRUCTIONS];
+        timing.llc_misses = counters[PERF_LLC_MISSES];
+        timing.branch_misses = counters[PERF_BRANCH_MISSES];
+        timing.dtlb_misses = counters[PERF_DTLB_MISSES];
+        result_.stages.push_back(std::move(timing));
+        MetricsRecordStage(name_, seconds);
+    }
+
+    StageScope(const StageScope&) = delete;
+    StageScope& operator=(const StageScope&) = delete;
+
+private:
+    QuadriFlowResult& result_;
+    const char* name_;
+    Clock::time_point start_;
+    TraceScope trace_;
+    AllocationScope allocations_;
+    PerfCounterScope counters_;
+};
+
+bool allocation_accounting_available() {
+    return kAllocationAccounting;
+}
+
+// Cost of the remaining stages relative to the measured Initialize stage
+// (hierarchy build), which scales with the same working mesh.
+static const double kOrientationCost = 1.0;
+static const double kPositionCost = 1.5;
+static const double kExtractionCost = 2.0;
+
+struct StagePlan {
+    SolverSchedule schedule;
+    bool orientations_solved = false;   // hierarchy.mQ already optimized
+    bool aggressive_sat = false;
+    bool minimum_cost_flow = false;
+    bool reorder_output = false;
+    int encode_position_bits = 0;
+    unsigned degradations = DEGRADE_NONE;
+};
+
+static double PredictRemainingSeconds(
+    const StagePlan& plan, const Hierarchy& mRes,
+    double unit_seconds, bool orientations_done
 ) {
+    const QuadriFlowCostModel model;
+    const double smoothing = ScheduleCost(mRes, plan.schedule);
+    double seconds = kPositionCost * smoothing;
+    if (!orientations_done) seconds += kOrientationCost * smoothing;
+    double extraction = kExtractionCost;
+    if (plan.aggressive_sat)    extraction *= model.aggressive_sat_factor;
+    if (plan.minimum_cost_flow) extraction *= model.minimum_cost_flow_factor;
+    return (seconds + extraction) * unit_seconds;
+}
+
+// Degrade `plan` in order of increasing quality loss until the remaining
+// stages are predicted to fit into `remaining_seconds`.
+static void FitPlanToBudget(
+    StagePlan& plan, const Hierarchy& mRes,
+    double unit_seconds, double remaining_seconds, bool orientations_done
+) {
+    auto fits = [&]() {
+        return PredictRemainingSeconds(plan, mRes, unit_seconds, orientations_done)
+            <= remaining_seconds;
+    };
+    if (plan.minimum_cost_flow && !fits()) {
+        plan.minimum_cost_flow = false;
+        plan.degradations |= DEGRADE_SKIP_MINIMUM_COST_FLOW;
+    }
+    if (plan.aggressive_sat && !fits()) {
+        plan.aggressive_sat = false;
+        plan.degradations |= DEGRADE_SKIP_AGGRESSIVE_SAT;
+    }
+    while (plan.schedule.iterations > 1 && !fits()) {
+        plan.schedule.iterations /= 2;
+        plan.degradations |= DEGRADE_FEWER_ITERATIONS;
+    }
+    const int coarsest = (int)mRes.mV.size() - 1;
+    while (plan.schedule.finest_level < coarsest && !fits()) {
+        ++plan.schedule.finest_level;
+        plan.degradations |= DEGRADE_COARSE_LEVELS_ONLY;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Pipeline stages shared by run_quadriflow() and QuadriFlowSession
+// ---------------------------------------------------------------------------
+static void CheckSolverLimits(int64_t num_vertices, int64_t num_faces) {
+    if (num_vertices > kQuadriFlowMaxSolverVertices || num_faces > kQuadriFlowMaxSolverFaces) {
+        throw std::runtime_error(
+            "Mesh too large for the QuadriFlow solver (" + std::to_string(num_vertices) +
+            " vertices, " + std::to_string(num_faces) + " faces; at most " +
+            std::to_string(kQuadriFlowMaxSolverFaces) + " faces). "
+            "Remesh it in regions (face_mask) or decimate it first");
+    }
+}
+
+static void ValidateInput(int64_t num_vertices, int64_t num_faces, int target_faces) {
     if (num_vertices <= 0 || num_faces <= 0) {
         throw std::runtime_error("Input mesh is empty");
     }
     if (target_faces <= 0) {
         throw std::runtime_error("target_faces must be positive");
     }
+    CheckSolverLimits(num_vertices, num_faces);
+}
 
-    Parametrizer2 field;
+static void ConfigureField(Parametrizer2& field, const QuadriFlowOptions& options) {
+    if (options.encode_position_bits < 0 || options.encode_position_bits > 32) {
+        throw std::runtime_error("encode_position_bits must be in [0, 32]");
+    }
+    if (options.preserve_sharp)     field.flag_preserve_sharp = 1;
+    if (options.preserve_boundary)  field.flag_preserve_boundary = 1;
+    if (options.adaptive_scale)     field.flag_adaptive_scale = 1;
+    if (options.aggressive_sat)     field.flag_aggresive_sat = 1;
+    if (options.minimum_cost_flow)  field.flag_minimum_cost_flow = 1;
+    field.balanced_coloring = options.balanced_coloring;
 
-    // Set flags
-    if (preserve_sharp)     field.flag_preserve_sharp = 1;
-    if (preserve_boundary)  field.flag_preserve_boundary = 1;
-    if (adaptive_scale)     field.flag_adaptive_scale = 1;
-    if (aggressive_sat)     field.flag_aggresive_sat = 1;
-    if (minimum_cost_flow)  field.flag_minimum_cost_flow = 1;
+    field.hierarchy.rng_seed = options.seed;
+}
+
+// Call fn(data, bytes) for every large solver array: the working mesh and
+// each hierarchy level's per-vertex data. Per-vertex neighbour lists are
+// separate small blocks; only a level's array of list headers is visited.
+template <typename Fn>
+static void ForEachSolverArray(Parametrizer2& field, const Fn& fn) {
+    auto visit = [&](auto& array) {
+        fn(static_cast<void*>(array.data()), sizeof(*array.data()) * array.size());
+    };
+    auto visit_levels = [&](auto& levels) {
+        for (auto& level : levels) visit(level);
+    };
+    visit(field.V);
+    visit(field.N);
+    visit(field.F);
+    visit(field.V2E);
+    visit(field.E2E);
 
-    field.hierarchy.rng_seed = seed;
+    Hierarchy& mRes = field.hierarchy;
+    visit(mRes.mF);
+    visit(mRes.mE2E);
+    visit_levels(mRes.mV);
+    visit_levels(mRes.mN);
+    visit_levels(mRes.mQ);
+    visit_levels(mRes.mO);
+    visit_levels(mRes.mA);
+    visit_levels(mRes.mS);
+    visit_levels(mRes.mK);
+    visit_levels(mRes.mToUpper);
+    visit_levels(mRes.mToLower);
+    visit_levels(mRes.mCQ);
+    visit_levels(mRes.mCO);
+    visit_levels(mRes.mCQw);
+    visit_levels(mRes.mCOw);
+    visit_levels(mRes.mAdj);
+}
 
-    // Load mesh from arrays
-    field.LoadFromArrays(vertices, num_vertices, faces, num_faces);
-    field.Initialize(target_faces);
+// True if the level sweeps run on built-in pool workers of several nodes.
+// The executor is checked first: ThreadPoolSize() starts the pool, which a
+// host executor replaces.
+static bool SweepsSpanNodes() {
+    return get_executor() == default_executor() && NumaNodeCount() > 1 &&
+           ThreadPoolSize() > 1;
+}
+
+// The parallel sweeps hand the work items of a level to the pool workers
+// of the node NumaHomeNode gives their vertices. Move each level's
+// per-vertex solver data to match, so every node sweeps its own memory.
+// Small levels, swept on the calling thread, stay where they are.
+static void PlaceHierarchy(Hierarchy& mRes) {
+    auto partition_levels = [&](auto& levels) {
+        for (size_t l = 0; l < levels.size(); ++l) {
+            if (mRes.mV[l].cols() < kParallelPhaseVertices) continue;
+            NumaPartitionPages(levels[l].data(), sizeof(*levels[l].data()) * levels[l].size());
+        }
+    };
+    partition_levels(mRes.mV);
+    partition_levels(mRes.mN);
+    partition_levels(mRes.mQ);
+    partition_levels(mRes.mO);
+    partition_levels(mRes.mS);
+    partition_levels(mRes.mCQ);
+    partition_levels(mRes.mCO);
+    partition_levels(mRes.mCQw);
+    partition_levels(mRes.mCOw);
+    partition_levels(mRes.mAdj);
+}
+
+// Build the hierarchy of a loaded mesh and set up boundary constraints.
+// Returns the Initialize wall time, the unit of the budget cost model.
+static double InitializeField(
+    Parametrizer2& field, int target_faces, QuadriFlowResult& result
+) {
+    double unit_seconds;
+    {
+        const Clock::time_point start = Clock::now();
+        StageScope stage(result, "initialize");
+        field.Initialize(target_faces);
+        unit_seconds = SecondsSince(start);
+    }
+
+    if (HugePagesEnabled()) {
+        // Upstream allocated and filled the arrays through Eigen, so their
+        // pages are collapsed in place
+        StageScope stage(result, "hugepages");
+        ForEachSolverArray(field, CollapseHugePages);
+    }
+
+    if (field.balanced_coloring) {
+        StageScope stage(result, "coloring");
+        BalanceHierarchyPhases(field.hierarchy);
+    }
 
     // Handle boundary preservation constraints
     if (field.flag_preserve_boundary) {
+        StageScope stage(result, "constraints");
         Hierarchy& mRes = field.hierarchy;
         mRes.clearConstraints();
         for (uint32_t i = 0; i < 3 * mRes.mF.cols(); ++i) {
@@ -156,46 +410,1259 @@ QuadriFlowResult run_quadriflow(
         }
         mRes.propagateConstraints();
     }
+    return unit_seconds;
+}
+
+static double LoadAndInitialize(
+    Parametrizer2& field,
+    const double* vertices, int64_t num_vertices,
+    const int* faces, int64_t num_faces,
+    int target_faces, QuadriFlowResult& result
+) {
+    {
+        StageScope stage(result, "load");
+        field.LoadFromArrays(vertices, num_vertices, faces, num_faces);
+    }
+    return InitializeField(field, target_faces, result);
+}
+
+// Convert an extracted quad mesh back to input coordinates.
+static void FillResult(
+    const Parametrizer2& field,
+    const std::vector<Vector3d>& O, const std::vector<Vector4i>& F,
+    QuadriFlowResult& result
+) {
+    StageScope stage(result, "output");
+    result.num_vertices = static_cast<int64_t>(O.size());
+    result.num_faces = static_cast<int64_t>(F.size());
+    // Initialize moves the working mesh into the hierarchy's finest level
+    result.working_vertices = static_cast<int64_t>(field.hierarchy.mV[0].cols());
+    const auto& phases = field.hierarchy.mPhases;
+    result.phase_sizes.assign(phases.size(), {});
+    for (size_t level = 0; level < phases.size(); ++level) {
+        for (const auto& phase : phases[level]) {
+            result.phase_sizes[level].push_back((int64_t)phase.size());
+        }
+    }
+
+    if (result.num_vertices == 0 || result.num_faces == 0) {
+        throw std::runtime_error("QuadriFlow produced an empty mesh");
+    }
+
+    result.vertices.resize(O.size() * 3);
+    for (size_t i = 0; i < O.size(); ++i) {
+        auto t = O[i] * field.normalize_scale + field.normalize_offset;
+        result.vertices[i * 3 + 0] = t.x();
+        result.vertices[i * 3 + 1] = t.y();
+        result.vertices[i * 3 + 2] = t.z();
+    }
+
+    result.faces.resize(F.size() * 4);
+    for (size_t i = 0; i < F.size(); ++i) {
+        result.faces[i * 4 + 0] = F[i][0];
+        result.faces[i * 4 + 1] = F[i][1];
+        result.faces[i * 4 + 2] = F[i][2];
+        result.faces[i * 4 + 3] = F[i][3];
+    }
+}
+
+// Cache-optimized face order and first-use vertex order (reorder_output).
+static void ReorderResult(QuadriFlowResult& result) {
+    StageScope stage(result, "reorder");
+    ReorderForVertexCache(result.vertices, result.faces, 4);
+}
+
+// Positions outside the normalization cube are clamped by the encoder;
+// output vertices lie on the input surface up to this fraction of its size.
+static const double kEncodePadding = 1.0 / 64;
+
+// Quantize straight into result.encoded against the normalization cube
+// (normalize_offset +- normalize_scale, which bounds the input) instead of
+// another bounding-box pass, then release the float arrays.
+static void EncodeResult(const Parametrizer2& field, int position_bits, QuadriFlowResult& result) {
+    StageScope stage(result, "encode");
+    const double half_extent = field.normalize_scale * (1.0 + kEncodePadding);
+    double box_min[3], box_max[3];
+    for (int d = 0; d < 3; ++d) {
+        box_min[d] = field.normalize_offset[d] - half_extent;
+        box_max[d] = field.normalize_offset[d] + half_extent;
+    }
+    result.encoded = encode_quadriflow_result(result, position_bits, box_min, box_max);
+    std::vector<double>().swap(result.vertices);
+    std::vector<int>().swap(result.faces);
+}
+
+// Orientation -> scale -> positions -> index map extraction -> output.
+// `plan.schedule` may already be restricted (continuing from a preview);
+// with a budget the plan is degraded further as needed.
+static void SolveAndExtract(
+    Parametrizer2& field, StagePlan plan, double unit_seconds,
+    Clock::time_point call_start, double budget_seconds,
+    QuadriFlowResult& result
+) {
+    const bool budgeted = budget_seconds > 0;
+
+    // Plan the remaining stages against the deadline; re-planned once the
+    // orientation stage has been measured.
+    if (budgeted) {
+        FitPlanToBudget(plan, field.hierarchy, unit_seconds,
+                        budget_seconds - SecondsSince(call_start),
+                        plan.orientations_solved);
+    }
 
     // Optimization pipeline
-    Optimizer::optimize_orientations(field.hierarchy);
-    field.ComputeOrientationSingularities();
+    {
+        const Clock::time_point start = Clock::now();
+        StageScope stage(result, "orientations");
+        if (!plan.orientations_solved) {
+            OptimizeOrientations(field.hierarchy, plan.schedule);
 
-    if (field.flag_adaptive_scale == 1) {
-        field.EstimateSlope();
+            // Recalibrate the unit from the measured smoothing throughput
+            const double smoothing = ScheduleCost(field.hierarchy, plan.schedule);
+            if (smoothing > 0) {
+                unit_seconds = SecondsSince(start) / (kOrientationCost * smoothing);
+            }
+        }
+        field.ComputeOrientationSingularities();
+        result.num_singularities = static_cast<int>(field.singularities.size());
+    }
+    if (budgeted) {
+        FitPlanToBudget(plan, field.hierarchy, unit_seconds,
+                        budget_seconds - SecondsSince(call_start), true);
     }
 
-    Optimizer::optimize_scale(field.hierarchy, field.rho, field.flag_adaptive_scale);
-    field.flag_adaptive_scale = 1;
-    Optimizer::optimize_positions(field.hierarchy, field.flag_adaptive_scale);
-    field.ComputePositionSingularities();
+    {
+        StageScope stage(result, "scale");
+        if (field.flag_adaptive_scale == 1) {
+            field.EstimateSlope();
+        }
 
-    field.ComputeIndexMap();
+        Optimizer::optimize_scale(field.hierarchy, field.rho, field.flag_adaptive_scale);
+        field.flag_adaptive_scale = 1;
+    }
+    {
+        StageScope stage(result, "positions");
+        OptimizePositions(field.hierarchy, field.flag_adaptive_scale, plan.schedule);
+        field.ComputePositionSingularities();
+    }
+
+    {
+        StageScope stage(result, "extraction");
+        field.flag_aggresive_sat = plan.aggressive_sat ? 1 : 0;
+        field.flag_minimum_cost_flow = plan.minimum_cost_flow ? 1 : 0;
+        field.ComputeIndexMap();
+    }
+    result.degradations |= plan.degradations;
 
     // Extract output mesh
+    FillResult(field, field.O_compact, field.F_compact, result);
+    if (plan.reorder_output) ReorderResult(result);
+    if (plan.encode_position_bits) EncodeResult(field, plan.encode_position_bits, result);
+}
+
+// ---------------------------------------------------------------------------
+// Main pipeline
+// ---------------------------------------------------------------------------
+QuadriFlowResult run_quadriflow(
+    const double* vertices, int64_t num_vertices,
+    const int* faces, int64_t num_faces,
+    const QuadriFlowOptions& options
+) {
+    MetricsCallScope metrics(num_faces);
+    ProgressScope progress(options);
+    ValidateInput(num_vertices, num_faces, options.target_faces);
+
+    const Clock::time_point call_start = Clock::now();
     QuadriFlowResult result;
-    result.num_vertices = static_cast<int>(field.O_compact.size());
-    result.num_faces = static_cast<int>(field.F_compact.size());
+    result.seed = options.seed;
+    Parametrizer2 field;
+    ConfigureField(field, options);
 
-    if (result.num_vertices == 0 || result.num_faces == 0) {
-        throw std::runtime_error("QuadriFlow produced an empty mesh");
+    const double unit_seconds = LoadAndInitialize(
+        field, vertices, num_vertices, faces, num_faces, options.target_faces, result);
+    if (SweepsSpanNodes()) {
+        StageScope stage(result, "numa");
+        PlaceHierarchy(field.hierarchy);
     }
 
-    result.vertices.resize(result.num_vertices * 3);
-    for (int i = 0; i < result.num_vertices; ++i) {
-        auto t = field.O_compact[i] * field.normalize_scale + field.normalize_offset;
-        result.vertices[i * 3 + 0] = t.x();
-        result.vertices[i * 3 + 1] = t.y();
-        result.vertices[i * 3 + 2] = t.z();
+    StagePlan plan;
+    plan.aggressive_sat = options.aggressive_sat;
+    plan.minimum_cost_flow = options.minimum_cost_flow;
+    plan.reorder_output = options.reorder_output;
+    plan.encode_position_bits = options.encode_position_bits;
+    plan.schedule.domain_decomposition = options.domain_decomposition;
+    plan.schedule.chaotic_relaxation = options.chaotic_relaxation;
+    SolveAndExtract(field, plan, unit_seconds, call_start,
+                    options.time_budget_ms * 1e-3, result);
+    progress.Finished();
+    metrics.Succeeded(result.num_faces);
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// Chunked input
+// ---------------------------------------------------------------------------
+struct QuadriFlowMeshBuilder::Impl {
+    double tolerance;
+    // Loader storage, filled chunk by chunk (see Parametrizer2::LoadFromBuffers)
+    HugePageVector<Vector3d> positions;
+    HugePageVector<uint32_t> indices;
+    // Open-border vertices of the chunks added so far, by spatial hash cell
+    std::unordered_multimap<uint64_t, uint32_t> border;
+
+    // Integer cell coordinates of p: tolerance-sized cells, or the raw bit
+    // patterns when welding exact duplicates only.
+    void Cell(const Vector3d& p, int64_t c[3]) const {
+        for (int d = 0; d < 3; ++d) {
+            if (tolerance > 0) {
+                c[d] = (int64_t)std::floor(p[d] / tolerance);
+            } else {
+                const double x = p[d] + 0.0;  // -0.0 and 0.0 share a cell
+                std::memcpy(&c[d], &x, sizeof(x));
+            }
+        }
+    }
+
+    static uint64_t CellKey(int64_t x, int64_t y, int64_t z) {
+        uint64_t h = (uint64_t)x * 0x9E3779B97F4A7C15ull;
+        h ^= (uint64_t)y * 0xC2B2AE3D27D4EB4Full + (h << 6) + (h >> 2);
+        h ^= (uint64_t)z * 0x165667B19E3779F9ull + (h << 6) + (h >> 2);
+        return h;
+    }
+
+    // Closest earlier border vertex within the tolerance, or -1
+    int64_t FindWeld(const Vector3d& p) const {
+        int64_t c[3];
+        Cell(p, c);
+        const int reach = tolerance > 0 ? 1 : 0;
+        const double max_dist2 = tolerance * tolerance;
+        int64_t best = -1;
+        double best_dist2 = max_dist2;
+        for (int dx = -reach; dx <= reach; ++dx) {
+            for (int dy = -reach; dy <= reach; ++dy) {
+                for (int dz = -reach; dz <= reach; ++dz) {
+                    auto range = border.equal_range(CellKey(c[0] + dx, c[1] + dy, c[2] + dz));
+                    for (auto it = range.first; it != range.second; ++it) {
+                        const double dist2 = (positions[it->second] - p).squaredNorm();
+                        if (dist2 <= best_dist2) {
+                            best = it->second;
+                            best_dist2 = dist2;
+                        }
+                    }
+                }
+            }
+        }
+        return best;
+    }
+};
+
+QuadriFlowMeshBuilder::QuadriFlowMeshBuilder(double weld_tolerance) : impl_(new Impl()) {
+    if (!(weld_tolerance >= 0)) {
+        throw std::runtime_error("weld_tolerance must be non-negative");
+    }
+    impl_->tolerance = weld_tolerance;
+}
+
+QuadriFlowMeshBuilder::~QuadriFlowMeshBuilder() = default;
+
+int64_t QuadriFlowMeshBuilder::num_vertices() const {
+    return static_cast<int64_t>(impl_->positions.size());
+}
+
+int64_t QuadriFlowMeshBuilder::num_faces() const {
+    return static_cast<int64_t>(impl_->indices.size() / 3);
+}
+
+void QuadriFlowMeshBuilder::add_chunk(
+    const double* vertices, int64_t num_vertices,
+    const int* faces, int64_t num_faces
+) {
+    if (num_vertices <= 0 || num_faces <= 0) return;
+    Impl& b = *impl_;
+
+    // Open-border vertices of this chunk: endpoints of edges used once
+    std::unordered_map<uint64_t, int> edge_use;
+    edge_use.reserve((size_t)num_faces * 2);
+    for (int64_t f = 0; f < num_faces; ++f) {
+        for (int k = 0; k < 3; ++k) {
+            const int a = faces[f * 3 + k], c = faces[f * 3 + (k + 1) % 3];
+            if (a < 0 || a >= num_vertices) {
+                throw std::runtime_error("Face index out of range");
+            }
+            const uint64_t key = ((uint64_t)std::min(a, c) << 32) | (uint32_t)std::max(a, c);
+            edge_use[key] += 1;
+        }
+    }
+    std::vector<char> on_border(num_vertices, 0);
+    for (const auto& kv : edge_use) {
+        if (kv.second != 1) continue;
+        on_border[kv.first >> 32] = 1;
+        on_border[kv.first & 0xffffffffu] = 1;
+    }
+
+    // Map chunk vertices to loader vertices, welding border vertices to
+    // earlier chunks only; duplicates within a chunk stay distinct.
+    std::vector<int64_t> to_loader(num_vertices, -1);
+    std::vector<uint32_t> new_border;
+    for (int64_t f = 0; f < num_faces; ++f) {
+        uint32_t tri[3];
+        for (int k = 0; k < 3; ++k) {
+            const int v = faces[f * 3 + k];
+            if (to_loader[v] == -1) {
+                const double* q = vertices + (size_t)v * 3;
+                const Vector3d p(q[0], q[1], q[2]);
+                if (on_border[v]) to_loader[v] = b.FindWeld(p);
+                if (to_loader[v] == -1) {
+                    // Loader indices are uint32 (see Parametrizer2::LoadFromBuffers)
+                    if (b.positions.size() >= 0xffffffffu) {
+                        throw std::runtime_error("QuadriFlowMeshBuilder holds at most 2^32 - 1 vertices");
+                    }
+                    to_loader[v] = (int64_t)b.positions.size();
+                    b.positions.push_back(p);
+                    if (on_border[v]) new_border.push_back((uint32_t)to_loader[v]);
+                }
+            }
+            tri[k] = (uint32_t)to_loader[v];
+        }
+        if (tri[0] == tri[1] || tri[1] == tri[2] || tri[2] == tri[0]) continue;
+        b.indices.insert(b.indices.end(), tri, tri + 3);
+    }
+
+    for (uint32_t v : new_border) {
+        int64_t c[3];
+        b.Cell(b.positions[v], c);
+        b.border.emplace(Impl::CellKey(c[0], c[1], c[2]), v);
+    }
+}
+
+QuadriFlowResult QuadriFlowMeshBuilder::remesh(const QuadriFlowOptions& options) {
+    Impl& b = *impl_;
+    MetricsCallScope metrics(num_faces());
+    ProgressScope progress(options);
+    ValidateInput(num_vertices(), num_faces(), options.target_faces);
+
+    const Clock::time_point call_start = Clock::now();
+    QuadriFlowResult result;
+    result.seed = options.seed;
+    Parametrizer2 field;
+    ConfigureField(field, options);
+
+    {
+        StageScope stage(result, "load");
+        std::unordered_multimap<uint64_t, uint32_t>().swap(b.border);
+        field.LoadFromBuffers(b.positions, b.indices);
+    }
+    const double unit_seconds = InitializeField(field, options.target_faces, result);
+
+    StagePlan plan;
+    plan.aggressive_sat = options.aggressive_sat;
+    plan.minimum_cost_flow = options.minimum_cost_flow;
+    plan.reorder_output = options.reorder_output;
+    plan.encode_position_bits = options.encode_position_bits;
+    plan.schedule.domain_decomposition = options.domain_decomposition;
+    plan.schedule.chaotic_relaxation = options.chaotic_relaxation;
+    SolveAndExtract(field, plan, unit_seconds, call_start,
+                    options.time_budget_ms * 1e-3, result);
+    progress.Finished();
+    metrics.Succeeded(result.num_faces);
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// Persistent session (preview + continuation)
+// ---------------------------------------------------------------------------
+struct QuadriFlowSession::Impl {
+    // Input copies, shared with saved states
+    std::shared_ptr<std::vector<double>> vertices = std::make_shared<std::vector<double>>();
+    std::shared_ptr<std::vector<int>> faces = std::make_shared<std::vector<int>>();
+    QuadriFlowOptions options;
+
+    std::shared_ptr<Parametrizer2> field;  // shared with field views
+    bool extracted = false;      // `field` was consumed by a full run
+    int initialized_target = 0;  // target_faces the hierarchy was built for
+    double base_scale = 0;       // hierarchy.mScale right after Initialize
+    double unit_seconds = 0;     // Initialize wall time (budget unit)
+    int preview_level = -1;      // fields solved on levels >= this, or -1
+    int preview_target = 0;
+
+    void Reset(int target_faces, QuadriFlowResult& result) {
+        field = std::make_shared<Parametrizer2>();
+        extracted = false;
+        ConfigureField(*field, options);
+        unit_seconds = LoadAndInitialize(
+            *field, vertices->data(), (int64_t)(vertices->size() / 3),
+            faces->data(), (int64_t)(faces->size() / 3), target_faces, result);
+        if (SweepsSpanNodes()) {
+            StageScope stage(result, "numa");
+            PlaceHierarchy(field->hierarchy);
+        }
+        initialized_target = target_faces;
+        base_scale = field->hierarchy.mScale;
+        preview_level = -1;
+    }
+};
+
+QuadriFlowSession::QuadriFlowSession(
+    const double* vertices, int64_t num_vertices,
+    const int* faces, int64_t num_faces,
+    const QuadriFlowOptions& options
+) : impl_(new Impl()) {
+    if (num_vertices <= 0 || num_faces <= 0) {
+        throw std::runtime_error("Input mesh is empty");
+    }
+    CheckSolverLimits(num_vertices, num_faces);
+    impl_->vertices->assign(vertices, vertices + (size_t)num_vertices * 3);
+    impl_->faces->assign(faces, faces + (size_t)num_faces * 3);
+    impl_->options = options;
+}
+
+QuadriFlowSession::~QuadriFlowSession() = default;
+
+QuadriFlowResult QuadriFlowSession::preview(int target_faces) {
+    if (target_faces <= 0) {
+        throw std::runtime_error("target_faces must be positive");
     }
+    Impl& s = *impl_;
+    ProgressScope progress(s.options);
+
+    QuadriFlowResult result;
+    if (!s.field || s.extracted) s.Reset(target_faces, result);
 
-    result.faces.resize(result.num_faces * 4);
-    for (int i = 0; i < result.num_faces; ++i) {
-        result.faces[i * 4 + 0] = field.F_compact[i][0];
-        result.faces[i * 4 + 1] = field.F_compact[i][1];
-        result.faces[i * 4 + 2] = field.F_compact[i][2];
-        result.faces[i * 4 + 3] = field.F_compact[i][3];
+    // A different target only changes the lattice spacing; the hierarchy
+    // is reused so slider moves never rebuild it.
+    Hierarchy& mRes = s.field->hierarchy;
+    mRes.mScale = s.base_scale * std::sqrt((double)s.initialized_target / target_faces);
+
+    SolverSchedule schedule;
+    schedule.finest_level = PreviewLevel(mRes, target_faces);
+    schedule.stop_at_finest = true;
+    schedule.domain_decomposition = s.options.domain_decomposition;
+    schedule.chaotic_relaxation = s.options.chaotic_relaxation;
+    {
+        StageScope stage(result, "orientations");
+        OptimizeOrientations(mRes, schedule);
+    }
+    {
+        StageScope stage(result, "positions");
+        OptimizePositions(mRes, 0, schedule);
+    }
+    std::vector<Vector3d> O;
+    std::vector<Vector4i> F;
+    {
+        StageScope stage(result, "extraction");
+        ExtractPreviewMesh(mRes, schedule.finest_level, mRes.mScale, O, F);
+    }
+    FillResult(*s.field, O, F, result);
+    if (s.options.reorder_output) ReorderResult(result);
+    if (s.options.encode_position_bits) {
+        EncodeResult(*s.field, s.options.encode_position_bits, result);
     }
 
+    s.preview_level = schedule.finest_level;
+    s.preview_target = target_faces;
+    progress.Finished();
     return result;
 }
+
+QuadriFlowResult QuadriFlowSession::run(int target_faces) {
+    Impl& s = *impl_;
+    MetricsCallScope metrics((int64_t)(s.faces->size() / 3));
+    ProgressScope progress(s.options);
+    if (target_faces <= 0) {
+        throw std::runtime_error("target_faces must be positive");
+    }
+
+    const Clock::time_point call_start = Clock::now();
+    QuadriFlowResult result;
+    if (!s.field || s.extracted || s.initialized_target != target_faces) {
+        s.Reset(target_faces, result);
+    }
+    s.field->hierarchy.mScale = s.base_scale;
+
+    StagePlan plan;
+    plan.aggressive_sat = s.options.aggressive_sat;
+    plan.minimum_cost_flow = s.options.minimum_cost_flow;
+    plan.reorder_output = s.options.reorder_output;
+    plan.encode_position_bits = s.options.encode_position_bits;
+    plan.schedule.domain_decomposition = s.options.domain_decomposition;
+    plan.schedule.chaotic_relaxation = s.options.chaotic_relaxation;
+    if (s.preview_level >= 0 && s.preview_target == target_faces) {
+        // The preview's levels are converged: start from its finest one and
+        // only refine the levels below it
+        plan.schedule.start_level = s.preview_level;
+        plan.schedule.coarsest_level = std::max(s.preview_level - 1, 0);
+    }
+
+    // Extraction consumes the parametrizer, so the next call starts afresh.
+    // Until then its solved fields stay available to field().
+    s.extracted = true;
+    s.preview_level = -1;
+    SolveAndExtract(*s.field, plan, s.unit_seconds, call_start,
+                    s.options.time_budget_ms * 1e-3, result);
+    progress.Finished();
+    metrics.Succeeded(result.num_faces);
+    return result;
+}
+
+int QuadriFlowSession::num_levels() const {
+    return impl_->field ? (int)impl_->field->hierarchy.mV.size() : 0;
+}
+
+int QuadriFlowSession::preview_level() const {
+    return impl_->preview_level;
+}
+
+QuadriFlowFieldView QuadriFlowSession::field(const std::string& name, int level) const {
+    const Impl& s = *impl_;
+    if (!s.field) {
+        throw std::runtime_error("No fields yet: call preview() or run() first");
+    }
+    const Hierarchy& mRes = s.field->hierarchy;
+    if (level < 0 || level >= (int)mRes.mV.size()) {
+        throw std::runtime_error("Hierarchy level out of range");
+    }
+
+    const MatrixXd* matrix;
+    if (name == "V")      matrix = &mRes.mV[level];
+    else if (name == "N") matrix = &mRes.mN[level];
+    else if (name == "Q") matrix = &mRes.mQ[level];
+    else if (name == "O") matrix = &mRes.mO[level];
+    else if (name == "S") matrix = &mRes.mS[level];
+    else throw std::runtime_error("Unknown field '" + name + "' (expected V, N, Q, O or S)");
+
+    QuadriFlowFieldView view;
+    view.data = matrix->data();
+    view.rows = (int64_t)matrix->rows();
+    view.cols = (int64_t)matrix->cols();
+    view.owner = s.field;
+    return view;
+}
+
+void QuadriFlowSession::normalization(double offset[3], double* scale) const {
+    if (!impl_->field) {
+        throw std::runtime_error("No fields yet: call preview() or run() first");
+    }
+    for (int d = 0; d < 3; ++d) offset[d] = impl_->field->normalize_offset[d];
+    *scale = impl_->field->normalize_scale;
+}
+
+// ---------------------------------------------------------------------------
+// Session state transport
+// ---------------------------------------------------------------------------
+
+static const int kSessionStateVersion = 4;
+
+template <typename T> struct StateDtype;
+template <> struct StateDtype<double> { static constexpr char value = 'f'; };
+template <> struct StateDtype<int> { static constexpr char value = 'i'; };
+template <> struct StateDtype<int64_t> { static constexpr char value = 'q'; };
+
+// Collects arrays that alias the saved storage, kept alive by `owner`.
+struct StateWriter {
+    QuadriFlowSessionState& state;
+    std::shared_ptr<const void> owner;
+
+    void Put(const std::string& name, char dtype, int64_t rows, int64_t cols,
+             const void* data, std::shared_ptr<const void> keep) {
+        QuadriFlowStateArray array;
+        array.name = name;
+        array.dtype = dtype;
+        array.rows = rows;
+        array.cols = cols;
+        array.data = data;
+        array.owner = std::move(keep);
+        state.arrays.push_back(std::move(array));
+    }
+
+    template <typename Derived>
+    void Array(const std::string& name, Eigen::PlainObjectBase<Derived>& m) {
+        Put(name, StateDtype<typename Derived::Scalar>::value, m.rows(), m.cols(), m.data(), owner);
+    }
+    template <typename T>
+    void Array(const std::string& name, std::vector<T>& v) {
+        Put(name, StateDtype<T>::value, (int64_t)v.size(), 1, v.data(), owner);
+    }
+    template <typename T>
+    void Scalar(const std::string& name, T& value) {
+        state.scalars.emplace_back(name, (double)value);
+    }
+    template <typename Level>
+    void Levels(const std::string& name, std::vector<Level>& levels) {
+        int64_t count = (int64_t)levels.size();
+        Scalar(name + ".levels", count);
+        for (size_t i = 0; i < levels.size(); ++i) Array(name + "." + std::to_string(i), levels[i]);
+    }
+
+    // Nested lists as offsets + flat items, in new storage
+    template <typename Item>
+    void Lists(const std::string& name, std::vector<int64_t> offsets, std::vector<Item> items) {
+        auto o = std::make_shared<std::vector<int64_t>>(std::move(offsets));
+        auto flat = std::make_shared<std::vector<Item>>(std::move(items));
+        Put(name + ".offsets", 'q', (int64_t)o->size(), 1, o->data(), o);
+        Put(name + ".items", StateDtype<Item>::value, (int64_t)flat->size(), 1, flat->data(), flat);
+    }
+    void Adjacency(const std::string& name, std::vector<AdjacentMatrix>& levels) {
+        int64_t count = (int64_t)levels.size();
+        Scalar(name + ".levels", count);
+        for (size_t l = 0; l < levels.size(); ++l) {
+            std::vector<int64_t> offsets(1, 0);
+            std::vector<int> ids;
+            auto weights = std::make_shared<std::vector<double>>();
+            for (const auto& list : levels[l]) {
+                for (const Link& link : list) {
+                    ids.push_back(link.id);
+                    weights->push_back(link.weight);
+                }
+                offsets.push_back((int64_t)ids.size());
+            }
+            const std::string level = name + "." + std::to_string(l);
+            Put(level + ".weights", 'f', (int64_t)weights->size(), 1, weights->data(), weights);
+            Lists(level, std::move(offsets), std::move(ids));
+        }
+    }
+    void Phases(const std::string& name, std::vector<std::vector<std::vector<int>>>& levels) {
+        int64_t count = (int64_t)levels.size();
+        Scalar(name + ".levels", count);
+        for (size_t l = 0; l < levels.size(); ++l) {
+            std::vector<int64_t> offsets(1, 0);
+            std::vector<int> items;
+            for (const auto& phase : levels[l]) {
+                items.insert(items.end(), phase.begin(), phase.end());
+                offsets.push_back((int64_t)items.size());
+            }
+            Lists(name + "." + std::to_string(l), std::move(offsets), std::move(items));
+        }
+    }
+};
+
+// Copies arrays of a saved state back, checking names, types and sizes.
+struct StateReader {
+    std::unordered_map<std::string, const QuadriFlowStateArray*> arrays;
+    std::unordered_map<std::string, double> scalars;
+
+    explicit StateReader(const QuadriFlowSessionState& state) {
+        for (const auto& array : state.arrays) arrays[array.name] = &array;
+        for (const auto& scalar : state.scalars) scalars[scalar.first] = scalar.second;
+    }
+
+    const QuadriFlowStateArray& Get(const std::string& name, char dtype) const {
+        auto it = arrays.find(name);
+        if (it == arrays.end()) throw std::runtime_error("Session state lacks array '" + name + "'");
+        const QuadriFlowStateArray& array = *it->second;
+        if (array.dtype != dtype || array.rows < 0 || array.cols < 0 ||
+            (array.rows * array.cols > 0 && !array.data)) {
+            throw std::runtime_error("Session state array '" + name + "' is malformed");
+        }
+        return array;
+    }
+
+    template <typename Derived>
+    void Array(const std::string& name, Eigen::PlainObjectBase<Derived>& m) {
+        using T = typename Derived::Scalar;
+        const QuadriFlowStateArray& array = Get(name, StateDtype<T>::value);
+        if ((Derived::RowsAtCompileTime != Eigen::Dynamic && array.rows != Derived::RowsAtCompileTime) ||
+            (Derived::ColsAtCompileTime != Eigen::Dynamic && array.cols != Derived::ColsAtCompileTime)) {
+            throw std::runtime_error("Session state array '" + name + "' has the wrong shape");
+        }
+        m.resize(array.rows, array.cols);
+        if (m.size() > 0) std::memcpy(m.data(), array.data, sizeof(T) * m.size());
+    }
+    template <typename T>
+    void Array(const std::string& name, std::vector<T>& v) {
+        const QuadriFlowStateArray& array = Get(name, StateDtype<T>::value);
+        const T* data = static_cast<const T*>(array.data);
+        v.assign(data, data + array.rows * array.cols);
+    }
+    template <typename T>
+    void Scalar(const std::string& name, T& value) {
+        auto it = scalars.find(name);
+        if (it == scalars.end()) throw std::runtime_error("Session state lacks '" + name + "'");
+        value = (T)it->second;
+    }
+    int64_t LevelCount(const std::string& name) {
+        int64_t count = 0;
+        Scalar(name + ".levels", count);
+        if (count < 0 || count > Hierarchy::MAX_DEPTH + 1) {
+            throw std::runtime_error("Session state '" + name + "' has a bad level count");
+        }
+        return count;
+    }
+    template <typename Level>
+    void Levels(const std::string& name, std::vector<Level>& levels) {
+        levels.resize((size_t)LevelCount(name));
+        for (size_t i = 0; i < levels.size(); ++i) Array(name + "." + std::to_string(i), levels[i]);
+    }
+
+    // Calls fill(i, begin, end) for every list of an offsets + items pair;
+    // returns the list count
+    template <typename Item, typename Fn>
+    size_t Lists(const std::string& name, const Fn& fill) {
+        const QuadriFlowStateArray& offsets = Get(name + ".offsets", 'q');
+        const QuadriFlowStateArray& items = Get(name + ".items", StateDtype<Item>::value);
+        const int64_t* o = static_cast<const int64_t*>(offsets.data);
+        const Item* data = static_cast<const Item*>(items.data);
+        if (offsets.rows < 1 || o[0] != 0 || o[offsets.rows - 1] != items.rows) {
+            throw std::runtime_error("Session state lists '" + name + "' are malformed");
+        }
+        const size_t count = (size_t)offsets.rows - 1;
+        for (size_t i = 0; i < count; ++i) {
+            if (o[i + 1] < o[i]) throw std::runtime_error("Session state lists '" + name + "' are malformed");
+            fill(i, data + o[i], data + o[i + 1]);
+        }
+        return count;
+    }
+    void Adjacency(const std::string& name, std::vector<AdjacentMatrix>& levels) {
+        levels.assign((size_t)LevelCount(name), AdjacentMatrix());
+        for (size_t l = 0; l < levels.size(); ++l) {
+            const std::string level = name + "." + std::to_string(l);
+            const QuadriFlowStateArray& weights = Get(level + ".weights", 'f');
+            const double* w = static_cast<const double*>(weights.data);
+            AdjacentMatrix& adj = levels[l];
+            int64_t k = 0;
+            Lists<int>(level, [&](size_t i, const int* begin, const int* end) {
+                if (adj.size() <= i) adj.resize(i + 1);
+                if (k + (end - begin) > weights.rows) {
+                    throw std::runtime_error("Session state lists '" + level + "' are malformed");
+                }
+                for (const int* id = begin; id != end; ++id) adj[i].emplace_back(*id, w[k++]);
+            });
+        }
+    }
+    void Phases(const std::string& name, std::vector<std::vector<std::vector<int>>>& levels) {
+        levels.assign((size_t)LevelCount(name), {});
+        for (size_t l = 0; l < levels.size(); ++l) {
+            std::vector<std::vector<int>>& phases = levels[l];
+            Lists<int>(name + "." + std::to_string(l), [&](size_t, const int* begin, const int* end) {
+                phases.emplace_back(begin, end);
+            });
+        }
+    }
+};
+
+// Every array and scalar of a built, not yet extracted solver, in one place
+// so that saving and restoring cannot drift apart. Seed and flags come from
+// the options (ConfigureField).
+template <typename IO>
+static void TransferSolverState(Parametrizer2& field, IO& io) {
+    io.Array("V", field.V);
+    io.Array("N", field.N);
+    io.Array("Nf", field.Nf);
+    io.Array("F", field.F);
+    io.Array("rho", field.rho);
+    io.Array("V2E", field.V2E);
+    io.Array("E2E", field.E2E);
+    io.Array("boundary", field.boundary);
+    io.Array("nonManifold", field.nonManifold);
+    io.Array("sharp_edges", field.sharp_edges);
+    io.Array("A", field.A);
+    io.Scalar("normalize_scale", field.normalize_scale);
+    io.Scalar("normalize_offset.x", field.normalize_offset[0]);
+    io.Scalar("normalize_offset.y", field.normalize_offset[1]);
+    io.Scalar("normalize_offset.z", field.normalize_offset[2]);
+    io.Scalar("surface_area", field.surface_area);
+    io.Scalar("scale", field.scale);
+    io.Scalar("average_edge_length", field.average_edge_length);
+    io.Scalar("max_edge_length", field.max_edge_length);
+
+    Hierarchy& mRes = field.hierarchy;
+    io.Scalar("hierarchy.mScale", mRes.mScale);
+    io.Scalar("hierarchy.with_scale", mRes.with_scale);
+    io.Array("hierarchy.mF", mRes.mF);
+    io.Array("hierarchy.mE2E", mRes.mE2E);
+    io.Levels("hierarchy.mV", mRes.mV);
+    io.Levels("hierarchy.mN", mRes.mN);
+    io.Levels("hierarchy.mQ", mRes.mQ);
+    io.Levels("hierarchy.mO", mRes.mO);
+    io.Levels("hierarchy.mA", mRes.mA);
+    io.Levels("hierarchy.mS", mRes.mS);
+    io.Levels("hierarchy.mK", mRes.mK);
+    io.Levels("hierarchy.mToUpper", mRes.mToUpper);
+    io.Levels("hierarchy.mToLower", mRes.mToLower);
+    io.Levels("hierarchy.mCQ", mRes.mCQ);
+    io.Levels("hierarchy.mCO", mRes.mCO);
+    io.Levels("hierarchy.mCQw", mRes.mCQw);
+    io.Levels("hierarchy.mCOw", mRes.mCOw);
+    io.Adjacency("hierarchy.mAdj", mRes.mAdj);
+    io.Phases("hierarchy.mPhases", mRes.mPhases);
+}
+
+// Session and option scalars, saved and restored alike
+template <typename IO>
+static void TransferSessionScalars(QuadriFlowOptions& options, int& initialized_target,
+                                   double& base_scale, double& unit_seconds,
+                                   int& preview_level, int& preview_target, IO& io) {
+    io.Scalar("options.seed", options.seed);
+    io.Scalar("options.preserve_sharp", options.preserve_sharp);
+    io.Scalar("options.preserve_boundary", options.preserve_boundary);
+    io.Scalar("options.adaptive_scale", options.adaptive_scale);
+    io.Scalar("options.aggressive_sat", options.aggressive_sat);
+    io.Scalar("options.minimum_cost_flow", options.minimum_cost_flow);
+    io.Scalar("options.time_budget_ms", options.time_budget_ms);
+    io.Scalar("options.reorder_output", options.reorder_output);
+    io.Scalar("options.encode_position_bits", options.encode_position_bits);
+    io.Scalar("options.domain_decomposition", options.domain_decomposition);
+    io.Scalar("options.balanced_coloring", options.balanced_coloring);
+    io.Scalar("options.chaotic_relaxation", options.chaotic_relaxation);
+    io.Scalar("session.initialized_target", initialized_target);
+    io.Scalar("session.base_scale", base_scale);
+    io.Scalar("session.unit_seconds", unit_seconds);
+    io.Scalar("session.preview_level", preview_level);
+    io.Scalar("session.preview_target", preview_target);
+}
+
+// The reader checks array sizes only. Before the solver follows any index
+// of a restored state, check that every one stays inside the arrays it
+// points into, so a corrupt or truncated state fails here rather than
+// reading or writing out of bounds.
+static void ValidateSolverState(const Parametrizer2& field, int preview_level) {
+    auto fail = [](const std::string& what) {
+        throw std::runtime_error("Session state is inconsistent: " + what);
+    };
+    // ids[0, count) in [0, bound), or -1 where `missing` is allowed
+    auto ids = [&](const int* ids, int64_t count, int64_t bound, bool missing,
+                   const std::string& what) {
+        for (int64_t i = 0; i < count; ++i) {
+            if (ids[i] >= bound || ids[i] < (missing ? -1 : 0)) fail(what + " index out of range");
+        }
+    };
+    auto shape = [&](int64_t rows, int64_t cols, int64_t want_rows, int64_t want_cols,
+                     const std::string& what) {
+        if (rows != want_rows || cols != want_cols) fail(what + " has the wrong shape");
+    };
+
+    const int64_t nv = field.V.cols();
+    const int64_t nf = field.F.cols();
+    shape(field.V.rows(), nv, 3, nv, "V");
+    shape(field.F.rows(), nf, 3, nf, "F");
+    ids(field.F.data(), field.F.size(), nv, false, "F");
+    shape(field.E2E.size(), 1, 3 * nf, 1, "E2E");
+    ids(field.E2E.data(), field.E2E.size(), 3 * nf, true, "E2E");
+    shape(field.V2E.size(), 1, nv, 1, "V2E");
+    ids(field.V2E.data(), field.V2E.size(), 3 * nf, true, "V2E");
+    shape(field.boundary.size(), 1, nv, 1, "boundary");
+    shape(field.nonManifold.size(), 1, nv, 1, "nonManifold");
+
+    const Hierarchy& mRes = field.hierarchy;
+    const int64_t levels = (int64_t)mRes.mV.size();
+    if (levels < 1) fail("no hierarchy levels");
+    for (size_t count : {mRes.mN.size(), mRes.mQ.size(), mRes.mO.size(), mRes.mA.size(),
+                         mRes.mAdj.size(), mRes.mPhases.size()}) {
+        if ((int64_t)count != levels) fail("hierarchy level counts differ");
+    }
+    if ((int64_t)mRes.mToUpper.size() != levels - 1 ||
+        (int64_t)mRes.mToLower.size() != levels - 1) {
+        fail("hierarchy level counts differ");
+    }
+    for (size_t count : {mRes.mS.size(), mRes.mK.size(), mRes.mCQ.size(), mRes.mCO.size(),
+                         mRes.mCQw.size(), mRes.mCOw.size()}) {
+        if (count != 0 && (int64_t)count != levels) fail("hierarchy level counts differ");
+    }
+    if (preview_level < -1 || preview_level >= levels) fail("preview level out of range");
+
+    const int64_t n0 = mRes.mV[0].cols();
+    const int64_t mnf = mRes.mF.cols();
+    shape(mRes.mF.rows(), mnf, 3, mnf, "hierarchy.mF");
+    ids(mRes.mF.data(), mRes.mF.size(), n0, false, "hierarchy.mF");
+    shape(mRes.mE2E.size(), 1, 3 * mnf, 1, "hierarchy.mE2E");
+    ids(mRes.mE2E.data(), mRes.mE2E.size(), 3 * mnf, true, "hierarchy.mE2E");
+
+    for (int64_t l = 0; l < levels; ++l) {
+        const std::string at = " at level " + std::to_string(l);
+        const int64_t n = mRes.mV[l].cols();
+        shape(mRes.mV[l].rows(), n, 3, n, "hierarchy.mV" + at);
+        shape(mRes.mN[l].rows(), mRes.mN[l].cols(), 3, n, "hierarchy.mN" + at);
+        shape(mRes.mQ[l].rows(), mRes.mQ[l].cols(), 3, n, "hierarchy.mQ" + at);
+        shape(mRes.mO[l].rows(), mRes.mO[l].cols(), 3, n, "hierarchy.mO" + at);
+        shape(mRes.mA[l].size(), 1, n, 1, "hierarchy.mA" + at);
+        // Optional per-vertex arrays: empty, or one column per vertex
+        auto optional = [&](const auto& level, const char* name) {
+            if (level.size() > 0 && level.cols() != n) fail(std::string(name) + " has the wrong shape" + at);
+        };
+        if (!mRes.mS.empty()) optional(mRes.mS[l], "hierarchy.mS");
+        if (!mRes.mK.empty()) optional(mRes.mK[l], "hierarchy.mK");
+        if (!mRes.mCQ.empty()) optional(mRes.mCQ[l], "hierarchy.mCQ");
+        if (!mRes.mCO.empty()) optional(mRes.mCO[l], "hierarchy.mCO");
+        if (!mRes.mCQw.empty() && mRes.mCQw[l].size() > 0 && mRes.mCQw[l].size() != n) {
+            fail("hierarchy.mCQw has the wrong shape" + at);
+        }
+        if (!mRes.mCOw.empty() && mRes.mCOw[l].size() > 0 && mRes.mCOw[l].size() != n) {
+            fail("hierarchy.mCOw has the wrong shape" + at);
+        }
+
+        if ((int64_t)mRes.mAdj[l].size() != n) fail("hierarchy.mAdj has the wrong shape" + at);
+        for (const auto& links : mRes.mAdj[l]) {
+            for (const Link& link : links) {
+                if (link.id < 0 || link.id >= n) fail("hierarchy.mAdj index out of range" + at);
+            }
+        }
+        for (const auto& phase : mRes.mPhases[l]) {
+            ids(phase.data(), (int64_t)phase.size(), n, false, "hierarchy.mPhases" + at);
+        }
+
+        if (l + 1 < levels) {
+            const int64_t coarse = mRes.mV[l + 1].cols();
+            shape(mRes.mToUpper[l].rows(), mRes.mToUpper[l].cols(), 2, coarse,
+                  "hierarchy.mToUpper" + at);
+            ids(mRes.mToUpper[l].data(), mRes.mToUpper[l].size(), n, true,
+                "hierarchy.mToUpper" + at);
+            shape(mRes.mToLower[l].size(), 1, n, 1, "hierarchy.mToLower" + at);
+            ids(mRes.mToLower[l].data(), mRes.mToLower[l].size(), coarse, false,
+                "hierarchy.mToLower" + at);
+        }
+    }
+}
+
+QuadriFlowSessionState QuadriFlowSession::save_state() const {
+    Impl& s = *impl_;
+    QuadriFlowSessionState state;
+    StateWriter writer{state, nullptr};
+
+    int version = kSessionStateVersion;
+    writer.Scalar("version", version);
+    writer.owner = s.vertices;
+    writer.Array("input.vertices", *s.vertices);
+    writer.owner = s.faces;
+    writer.Array("input.faces", *s.faces);
+    TransferSessionScalars(s.options, s.initialized_target, s.base_scale, s.unit_seconds,
+                           s.preview_level, s.preview_target, writer);
+
+    // A consumed field is rebuilt by the next call anyway
+    int has_field = s.field && !s.extracted;
+    writer.Scalar("session.has_field", has_field);
+    if (has_field) {
+        writer.owner = s.field;
+        TransferSolverState(*s.field, writer);
+    }
+    return state;
+}
+
+QuadriFlowSession::QuadriFlowSession(const QuadriFlowSessionState& state) : impl_(new Impl()) {
+    Impl& s = *impl_;
+    StateReader reader(state);
+
+    int version = 0;
+    reader.Scalar("version", version);
+    if (version != kSessionStateVersion) {
+        throw std::runtime_error("Unsupported session state version " + std::to_string(version));
+    }
+    reader.Array("input.vertices", *s.vertices);
+    reader.Array("input.faces", *s.faces);
+    const int64_t num_vertices = (int64_t)(s.vertices->size() / 3);
+    const int64_t num_faces = (int64_t)(s.faces->size() / 3);
+    if (num_vertices <= 0 || num_faces <= 0) {
+        throw std::runtime_error("Input mesh is empty");
+    }
+    CheckSolverLimits(num_vertices, num_faces);
+    TransferSessionScalars(s.options, s.initialized_target, s.base_scale, s.unit_seconds,
+                           s.preview_level, s.preview_target, reader);
+
+    int has_field = 0;
+    reader.Scalar("session.has_field", has_field);
+    if (has_field) {
+        s.field = std::make_shared<Parametrizer2>();
+        ConfigureField(*s.field, s.options);
+        TransferSolverState(*s.field, reader);
+        ValidateSolverState(*s.field, s.preview_level);
+        if (HugePagesEnabled()) ForEachSolverArray(*s.field, CollapseHugePages);
+        if (SweepsSpanNodes()) PlaceHierarchy(s.field->hierarchy);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Best-of-N multi-seed remeshing
+// ---------------------------------------------------------------------------
+
+// Run body(i) for every i in [0, n) on the executor. The first exception
+// thrown by any body is rethrown on the caller; bodies never throw into the
+// executor. Heap activity and hardware counts of other threads are folded
+// into the caller's stage.
+template <typename Body>
+static void ParallelFor(int n, const Body& body) {
+    const std::shared_ptr<QuadriFlowExecutor> executor = get_executor();
+    const std::thread::id caller = std::this_thread::get_id();
+    std::exception_ptr error;
+    AllocationCounters workers = {};
+    int64_t counted[PERF_NUM_COUNTERS] = {};
+    std::mutex mutex;
+
+    executor->parallel_for(n, [&](int i) {
+        const bool on_worker = std::this_thread::get_id() != caller;
+        AllocationScope allocations;
+        PerfCounterScope counters;
+        try {
+            body(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error) error = std::current_exception();
+        }
+        if (!on_worker) return;  // ran inline: already the caller's own
+        const AllocationCounters delta = allocations.Finish();
+        int64_t count_delta[PERF_NUM_COUNTERS];
+        counters.Finish(count_delta);
+        std::lock_guard<std::mutex> lock(mutex);
+        AccumulateAllocations(workers, delta);
+        for (int c = 0; c < PERF_NUM_COUNTERS; ++c) {
+            if (count_delta[c] > 0) counted[c] += count_delta[c];
+        }
+    });
+    MergeAllocations(workers);
+    PerfCountersFold(counted);
+    if (error) std::rethrow_exception(error);
+}
+
+// Seed-dependent state of one candidate: its own per-level Q and O fields.
+// Everything else (geometry, adjacency, phases, constraints) is shared.
+struct SeedCandidate {
+    int seed = 0;
+    std::vector<MatrixXd> Q, O;
+    int num_singularities = 0;
+};
+
+// Random tangent orientations and lattice offsets for every level, drawn
+// like Hierarchy::Initialize does but from a per-candidate generator.
+static void RandomizeFields(const Hierarchy& mRes, SeedCandidate& candidate) {
+    pcg32 rng;
+    rng.seed(static_cast<uint64_t>(static_cast<uint32_t>(candidate.seed)));
+
+    candidate.Q.resize(mRes.mN.size());
+    candidate.O.resize(mRes.mN.size());
+    for (size_t l = 0; l < mRes.mN.size(); ++l) {
+        const MatrixXd& N = mRes.mN[l];
+        const MatrixXd& V = mRes.mV[l];
+        MatrixXd& Q = candidate.Q[l];
+        MatrixXd& O = candidate.O[l];
+        Q.resize(N.rows(), N.cols());
+        O.resize(N.rows(), N.cols());
+        AdviseHugePages(Q.data(), sizeof(double) * Q.size());
+        AdviseHugePages(O.data(), sizeof(double) * O.size());
+        for (int j = 0; j < N.cols(); ++j) {
+            Vector3d s, t;
+            coordinate_system(N.col(j), s, t);
+            const double angle = rng.nextDouble() * 2 * M_PI;
+            const double x = rng.nextDouble() * 2 - 1;
+            const double y = rng.nextDouble() * 2 - 1;
+            Q.col(j) = s * std::cos(angle) + t * std::sin(angle);
+            O.col(j) = V.col(j) + (s * x + t * y) * mRes.mScale;
+        }
+    }
+}
+
+// Same count as Parametrizer::ComputeOrientationSingularities, without
+// touching the parametrizer.
+static int CountOrientationSingularities(const Hierarchy& mRes, const MatrixXd& Q) {
+    const MatrixXd& N = mRes.mN[0];
+    const MatrixXi& F = mRes.mF;
+    int count = 0;
+    for (int f = 0; f < F.cols(); ++f) {
+        int index = 0;
+        for (int k = 0; k < 3; ++k) {
+            const int i = F(k, f), j = F(k == 2 ? 0 : (k + 1), f);
+            auto value = compat_orientation_extrinsic_index_4(
+                Q.col(i), N.col(i), Q.col(j), N.col(j));
+            index += value.second - value.first;
+        }
+        const int index_mod = modulo(index, 4);
+        if (index_mod == 1 || index_mod == 3) ++count;
+    }
+    return count;
+}
+
+std::vector<QuadriFlowResult> run_quadriflow_seeds(
+    const double* vertices, int64_t num_vertices,
+    const int* faces, int64_t num_faces,
+    const QuadriFlowOptions& options,
+    const std::vector<int>& seeds,
+    bool keep_all
+) {
+    MetricsCallScope metrics(num_faces);
+    ProgressScope progress(options);
+    ValidateInput(num_vertices, num_faces, options.target_faces);
+    if (seeds.empty()) {
+        throw std::runtime_error("seeds must not be empty");
+    }
+    auto succeeded = [&](const std::vector<QuadriFlowResult>& results) {
+        int64_t output_faces = 0;
+        for (const auto& r : results) output_faces += r.num_faces;
+        progress.Finished();
+        metrics.Succeeded(output_faces);
+    };
+
+    const Clock::time_point call_start = Clock::now();
+    QuadriFlowResult shared;   // stage timings common to every candidate
+    Parametrizer2 field;
+    ConfigureField(field, options);
+
+    const double unit_seconds = LoadAndInitialize(
+        field, vertices, num_vertices, faces, num_faces, options.target_faces, shared);
+
+    // Every candidate reads the whole shared hierarchy from threads on all
+    // nodes: spread it evenly over the nodes' memory instead of the loader's
+    if (NumaNodeCount() > 1 && seeds.size() > 1) {
+        StageScope stage(shared, "numa");
+        ForEachSolverArray(field, NumaInterleavePages);
+    }
+
+    std::vector<SeedCandidate> candidates(seeds.size());
+    {
+        StageScope stage(shared, "seed_candidates");
+        const Hierarchy& mRes = field.hierarchy;
+        ParallelFor((int)candidates.size(), [&](int i) {
+            TraceScope trace("seed_candidate", i);
+            SeedCandidate& candidate = candidates[i];
+            candidate.seed = seeds[i];
+            RandomizeFields(mRes, candidate);
+            OptimizeOrientations(mRes, candidate.Q);
+            candidate.num_singularities = CountOrientationSingularities(mRes, candidate.Q[0]);
+        });
+    }
+
+    auto finish = [&](Parametrizer2& target, SeedCandidate& candidate) {
+        QuadriFlowResult result = shared;
+        result.seed = candidate.seed;
+        target.hierarchy.mQ = std::move(candidate.Q);
+        target.hierarchy.mO = std::move(candidate.O);
+
+        StagePlan plan;
+        plan.orientations_solved = true;
+        plan.aggressive_sat = options.aggressive_sat;
+        plan.minimum_cost_flow = options.minimum_cost_flow;
+        plan.reorder_output = options.reorder_output;
+        plan.encode_position_bits = options.encode_position_bits;
+        plan.schedule.domain_decomposition = options.domain_decomposition;
+        plan.schedule.chaotic_relaxation = options.chaotic_relaxation;
+        SolveAndExtract(target, plan, unit_seconds, call_start,
+                        options.time_budget_ms * 1e-3, result);
+        return result;
+    };
+
+    std::vector<QuadriFlowResult> results;
+    if (!keep_all) {
+        size_t best = 0;
+        for (size_t i = 1; i < candidates.size(); ++i) {
+            if (candidates[i].num_singularities < candidates[best].num_singularities) best = i;
+        }
+        results.push_back(finish(field, candidates[best]));
+        succeeded(results);
+        return results;
+    }
+
+    // Every candidate is extracted from its own copy of the parametrizer.
+    // The scale, position and extraction stages run one candidate after
+    // the other: upstream ComputeIndexMap has not been audited for thread
+    // safety. Each copy lives for one candidate only.
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (i + 1 < candidates.size()) {
+            Parametrizer2 copy(field);
+            results.push_back(finish(copy, candidates[i]));
+        } else {
+            results.push_back(finish(field, candidates[i]));
+        }
+    }
+    succeeded(results);
+    return results;
+}
+
+// ---------------------------------------------------------------------------
+// Batch remeshing
+// ---------------------------------------------------------------------------
+
+std::vector<QuadriFlowResult> run_quadriflow_batch(
+    const std::vector<QuadriFlowMeshInput>& meshes,
+    const QuadriFlowOptions& options,
+    int max_workers
+) {
+    std::vector<QuadriFlowResult> results(meshes.size());
+    if (meshes.empty()) return results;
+
+    const std::shared_ptr<QuadriFlowExecutor> executor = get_executor();
+    const int num_workers = (int)std::min<size_t>(
+        std::min(max_workers > 0 ? max_workers : INT32_MAX, executor->concurrency()),
+        meshes.size());
+    const int num_nodes = NumaNodeCount();
+
+    // Pool workers are already spread over the nodes by their CPU shares;
+    // a host executor's threads are not known, so its meshes share node 0
+    const bool on_pool = executor == default_executor();
+    std::vector<int> node_workers(num_nodes, 0);
+    for (int w = 0; w < num_workers; ++w) ++node_workers[on_pool ? ThreadPoolWorkerNode(w) : 0];
+
+    // Deal the meshes, largest first, to the node with the least faces per
+    // worker; each queue is then worked in that order
+    std::vector<size_t> order(meshes.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return meshes[a].num_faces > meshes[b].num_faces;
+    });
+    std::vector<std::vector<size_t>> queues(num_nodes);
+    std::vector<double> load(num_nodes, 0.0);
+    for (size_t i : order) {
+        int best = -1;
+        for (int node = 0; node < num_nodes; ++node) {
+            if (node_workers[node] == 0) continue;
+            if (best < 0 || load[node] / node_workers[node] < load[best] / node_workers[best]) {
+                best = node;
+            }
+        }
+        queues[best].push_back(i);
+        load[best] += (double)std::max<int64_t>(meshes[i].num_faces, 1);
+    }
+    std::vector<std::atomic<size_t>> next(num_nodes);
+    for (auto& n : next) n.store(0);
+
+    std::atomic<bool> failed(false);
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    executor->parallel_for(num_workers, [&](int) {
+        const int node = ThreadPoolCurrentNode();
+        // Own queue first, then the other nodes' leftovers
+        for (int k = 0; k < num_nodes && !failed; ++k) {
+            const int source = (node + k) % num_nodes;
+            for (size_t slot = next[source]++; slot < queues[source].size() && !failed;
+                 slot = next[source]++) {
+                const size_t i = queues[source][slot];
+                const QuadriFlowMeshInput& mesh = meshes[i];
+                try {
+                    results[i] = run_quadriflow(mesh.vertices, mesh.num_vertices,
+                                                mesh.faces, mesh.num_faces, options);
+                    results[i].numa_node = node;
+                } catch (const std::exception& e) {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (!error) {
+                        error = std::make_exception_ptr(std::runtime_error(
+                            "mesh " + std::to_string(i) + ": " + e.what()));
+                    }
+                    failed = true;
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (!error) error = std::current_exception();
+                    failed = true;
+                }
+            }
+        }
+    });
+    if (error) std::rethrow_exception(error);
+    return results;
+}
+
+QuadriFlowResult run_quadriflow(
+    const double* vertices, int64_t num_vertices,
+    const int* faces, int64_t num_faces,
+    int target_faces,
+    int seed,
+    bool preserve_sharp,
+    bool preserve_boundary,
+    bool adaptive_scale,
+    bool aggressive_sat,
+    bool minimum_cost_flow
+) {
+    QuadriFlowOptions options;
+    options.target_faces = target_faces;
+    options.seed = seed;
+    options.preserve_sharp = preserve_sharp;
+    options.preserve_boundary = preserve_boundary;
+    options.adaptive_scale = adaptive_scale;
+    options.aggressive_sat = aggressive_sat;
+    options.minimum_cost_flow = minimum_cost_flow;
+    return run_quadriflow(vertices, num_vertices, faces, num_faces, options);
+}
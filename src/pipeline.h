@@ -5,21 +5,137 @@
 #ifndef PYQUADRIFLOW_PIPELINE_H
 #define PYQUADRIFLOW_PIPELINE_H
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
+// Degradations applied by the pipeline to meet QuadriFlowOptions::time_budget_ms
+enum QuadriFlowDegradation : unsigned {
+    DEGRADE_NONE = 0,
+    DEGRADE_SKIP_MINIMUM_COST_FLOW = 1u << 0,  // minimum_cost_flow refinement dropped
+    DEGRADE_SKIP_AGGRESSIVE_SAT = 1u << 1,     // aggressive_sat refinement dropped
+    DEGRADE_FEWER_ITERATIONS = 1u << 2,        // fewer smoothing sweeps per level
+    DEGRADE_COARSE_LEVELS_ONLY = 1u << 3,      // finest levels only prolongated
+};
+
+// Element counts are 64-bit throughout this API; face indices are int32.
+// The QuadriFlow solver numbers vertices and face corners with int, so a
+// mesh that reaches it (the whole input, or the ROI submesh for
+// run_quadriflow_roi) is limited to these sizes. ROI extraction, the
+// builder's welding, estimate_resources and the quantized format are not.
+const int64_t kQuadriFlowMaxSolverVertices = 0x7fffffff;
+const int64_t kQuadriFlowMaxSolverFaces = 0x7fffffff / 3;
+
+struct QuadriFlowStageTiming {
+    std::string name;
+    double seconds;
+    // Heap activity of the stage, including its worker threads. Counted
+    // only in builds with PYQUADRIFLOW_ALLOC_STATS (see
+    // allocation_accounting_available()); zero otherwise.
+    uint64_t allocations = 0;
+    uint64_t frees = 0;
+    uint64_t bytes_allocated = 0;
+    int64_t peak_bytes = 0;       // high-water mark above the stage's start
+    // Hardware counters of the stage and its worker threads, user space
+    // only, while set_hardware_counters_enabled(true); -1 when not counted.
+    int64_t cycles = -1;
+    int64_t instructions = -1;
+    int64_t llc_misses = -1;
+    int64_t branch_misses = -1;
+    int64_t dtlb_misses = -1;     // data TLB load misses
+};
+
 struct QuadriFlowResult {
     std::vector<double> vertices;   // flat: [x0,y0,z0, x1,y1,z1, ...]
     std::vector<int> faces;         // flat: [v0,v1,v2,v3, ...] per quad face
-    int num_vertices;
-    int num_faces;
+    int64_t num_vertices;
+    int64_t num_faces;
+    unsigned degradations = DEGRADE_NONE;       // QuadriFlowDegradation bits
+    std::vector<QuadriFlowStageTiming> stages;  // wall time per stage, in order
+    int seed = 0;
+    int num_singularities = -1;                 // orientation singularities, -1 if not computed
+    std::vector<int> triangles;     // flat: [v0,v1,v2, ...]; ROI remeshing only
+    int64_t num_triangles = 0;
+    // Quantized encoding (see encode_quadriflow_result) when
+    // QuadriFlowOptions::encode_position_bits is set; `vertices` and `faces`
+    // are then released and only the counts are kept.
+    std::vector<unsigned char> encoded;
+    int64_t working_vertices = 0;   // vertices of the solver's working mesh
+    // Vertices per smoothing phase (colour class) of each hierarchy level,
+    // finest level first
+    std::vector<std::vector<int64_t>> phase_sizes;
+    int numa_node = -1;             // node the call ran on; batch remeshing only
+};
+
+struct QuadriFlowOptions {
+    int target_faces = 0;
+    int seed = 0;
+    bool preserve_sharp = false;
+    bool preserve_boundary = false;
+    bool adaptive_scale = false;
+    bool aggressive_sat = false;
+    bool minimum_cost_flow = false;
+    // Soft deadline for the whole call; 0 disables. When the remaining stages
+    // are predicted to overrun, the pipeline degrades (see QuadriFlowDegradation)
+    // instead of failing. Extraction itself cannot be preempted, so the
+    // deadline can still be missed on inputs where loading alone overruns it.
+    double time_budget_ms = 0;
+    // Reorder the output for vertex-cache and memory locality: faces in
+    // Tipsify order, vertices renumbered in order of first use.
+    bool reorder_output = false;
+    // Encode the output straight into result.encoded with positions
+    // quantized to this many bits (1-32); 0 keeps the float arrays.
+    int encode_position_bits = 0;
+    // Smooth each hierarchy level as spatially compact vertex blocks swept
+    // in parallel on the executor, exchanging the block borders between
+    // iterations (additive Schwarz), instead of colour by colour on the
+    // calling thread. For large meshes on many cores; the result differs
+    // slightly from the serial sweeps but not between thread counts.
+    bool domain_decomposition = false;
+    // Recolour the hierarchy levels in parallel (Jones-Plassmann) and balance
+    // the colour classes, so that the phases of the smoothing sweeps are of
+    // similar size and every phase keeps the executor busy. Changes the
+    // sweep order and so the result, but not between thread counts.
+    bool balanced_coloring = false;
+    // Chaotic (Hogwild-style) relaxation of the smoothing sweeps: threads
+    // update vertices with no colouring or iteration barriers, reading
+    // whatever their neighbours hold at the time. Fastest, for previews and
+    // other low-stakes jobs; the result varies from run to run.
+    // Overrides domain_decomposition.
+    bool chaotic_relaxation = false;
+    // Called on the calling thread as each stage starts, with the stage name
+    // and the nominal fraction of the call done (non-decreasing), and with
+    // ("done", 1) on success. Batch remeshing calls it per mesh, from
+    // several threads at once.
+    std::function<void(const char* stage, double fraction)> progress;
+    // Polled at every stage and between hierarchy levels of the smoothing
+    // sweeps; returning true aborts the call with QuadriFlowCancelled.
+    std::function<bool()> cancel;
+};
+
+// Thrown when QuadriFlowOptions::cancel asks a call to stop.
+class QuadriFlowCancelled : public std::runtime_error {
+public:
+    QuadriFlowCancelled() : std::runtime_error("Remeshing cancelled") {}
 };
 
 // Run the QuadriFlow quad-dominant remeshing pipeline.
 // Input: triangle mesh as flat arrays (vertices Nx3, faces Mx3).
 // Output: quad mesh.
 QuadriFlowResult run_quadriflow(
-    const double* vertices, int num_vertices,
-    const int* faces, int num_faces,
+    const double* vertices, int64_t num_vertices,
+    const int* faces, int64_t num_faces,
+    const QuadriFlowOptions& options
+);
+
+// Positional-flag overload, kept for existing callers.
+QuadriFlowResult run_quadriflow(
+    const double* vertices, int64_t num_vertices,
+    const int* faces, int64_t num_faces,
     int target_faces,
     int seed,
     bool preserve_sharp,
@@ -29,4 +145,430 @@ QuadriFlowResult run_quadriflow(
     bool minimum_cost_flow
 );
 
+// Best-of-N remeshing. Loads the mesh and builds the hierarchy once, then
+// solves the seed-dependent orientation field for every seed in parallel on
+// private copies of the field arrays and scores each natively by its
+// orientation singularity count. Returns the best result (fewest
+// singularities, earliest seed on ties), or one result per seed in `seeds`
+// order when `keep_all`. Candidate fields are drawn from a per-seed
+// generator, so seeds = {k} is reproducible but not bit-identical to
+// run_quadriflow() with seed = k.
+//
+// Only the orientation solves run in parallel. With `keep_all` the scale,
+// position and extraction stages run for one seed after the other, each on
+// a full copy of the parametrizer (hierarchy included), so every extra
+// seed adds a whole serial tail and the copy raises peak memory.
+std::vector<QuadriFlowResult> run_quadriflow_seeds(
+    const double* vertices, int64_t num_vertices,
+    const int* faces, int64_t num_faces,
+    const QuadriFlowOptions& options,
+    const std::vector<int>& seeds,
+    bool keep_all
+);
+
+// One input mesh of a batch, as flat arrays that outlive the call.
+struct QuadriFlowMeshInput {
+    const double* vertices;
+    int64_t num_vertices;
+    const int* faces;
+    int64_t num_faces;
+};
+
+// Remesh every mesh with the same options in up to `max_workers` parallel
+// tasks of the executor (0: its concurrency()), each mesh a run_quadriflow()
+// on one thread. With the default executor on a multi-socket machine the
+// pool's workers sit on the NUMA nodes in proportion to their CPUs, and the
+// meshes are dealt to per-node queues, largest first to the least loaded
+// node, so each mesh is copied in, solved and extracted in its worker's
+// local memory; a node that runs dry takes the remaining meshes of the
+// others. Results are in input order with numa_node set (0 on a host
+// executor). After a failure no new meshes are started and the first error
+// is rethrown, prefixed with the mesh index.
+std::vector<QuadriFlowResult> run_quadriflow_batch(
+    const std::vector<QuadriFlowMeshInput>& meshes,
+    const QuadriFlowOptions& options,
+    int max_workers = 0
+);
+
+// Region-of-interest remeshing. Only faces with a non-zero `face_mask`
+// entry are remeshed (to about options.target_faces quads), with their
+// border pinned through preserve_boundary; the quad patch is then zipped to
+// the untouched triangles by a band of triangles. The result holds the
+// original vertices still in use followed by the quad vertices, the quads
+// in `faces` and the untouched plus band triangles in `triangles`.
+// Holes the quad patch closes are left open. Remeshing cost scales with the
+// ROI; everything else is a linear copy.
+QuadriFlowResult run_quadriflow_roi(
+    const double* vertices, int64_t num_vertices,
+    const int* faces, int64_t num_faces,
+    const unsigned char* face_mask,
+    const QuadriFlowOptions& options
+);
+
+// ---------------------------------------------------------------------------
+// Quantized binary format
+// ---------------------------------------------------------------------------
+
+// Compact storage/transfer format for quad meshes. All fields little-endian:
+//
+//   offset  size  field
+//        0     4  magic "QFQM"
+//        4     2  version (1)
+//        6     1  position bits b (1-32)
+//        7     1  corners per face (4)
+//        8     8  num_vertices
+//       16     8  num_faces
+//       24    24  origin[3]   (float64)
+//       48    24  step[3]     (float64); position = origin + q * step
+//       72     8  index stream size in bytes
+//       80        positions: num_vertices * 3 quantized coordinates,
+//                 uint16 if b <= 16 else uint32, zero-padded to 8 bytes
+//        …        indices: per corner, zigzag LEB128 varint of the
+//                 difference to the previous index
+//
+// The positions block has a fixed offset and width, so a memory-mapped file
+// can be read without decoding. Index deltas are smallest after
+// reorder_output.
+
+// Quantize against [box_min, box_max] (clamping positions outside it), or
+// against the result's own bounding box when no box is given.
+std::vector<unsigned char> encode_quadriflow_result(
+    const QuadriFlowResult& result,
+    int position_bits,
+    const double* box_min = nullptr,
+    const double* box_max = nullptr
+);
+
+// Decode an encoded mesh, e.g. straight from a memory-mapped file.
+// Throws std::runtime_error on malformed input.
+QuadriFlowResult decode_quadriflow_result(const unsigned char* data, size_t size);
+
+// ---------------------------------------------------------------------------
+// Chunked input
+// ---------------------------------------------------------------------------
+
+// Assembles the input mesh from tiles without a concatenated copy. Each
+// chunk is appended straight into the loader's vertex and index storage,
+// and the vertices on a chunk's open border are welded to border vertices
+// of earlier chunks through a spatial hash (cell size = weld_tolerance;
+// 0 welds bit-identical positions only). Only border vertices are hashed,
+// so the weld table grows with the tile seams, not the mesh. As in
+// run_quadriflow(), vertices no face references are dropped.
+class QuadriFlowMeshBuilder {
+public:
+    explicit QuadriFlowMeshBuilder(double weld_tolerance = 0.0);
+    ~QuadriFlowMeshBuilder();
+
+    QuadriFlowMeshBuilder(const QuadriFlowMeshBuilder&) = delete;
+    QuadriFlowMeshBuilder& operator=(const QuadriFlowMeshBuilder&) = delete;
+
+    // Faces index the chunk's own vertices. Faces that collapse when their
+    // corners are welded are dropped.
+    void add_chunk(
+        const double* vertices, int64_t num_vertices,
+        const int* faces, int64_t num_faces
+    );
+
+    int64_t num_vertices() const;  // after welding
+    int64_t num_faces() const;
+
+    // Remesh the accumulated mesh. Its storage is handed to the pipeline,
+    // so the builder is empty afterwards.
+    QuadriFlowResult remesh(const QuadriFlowOptions& options);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// ---------------------------------------------------------------------------
+// Persistent session
+// ---------------------------------------------------------------------------
+
+// Read-only view of one per-level solver field: `rows` x `cols` doubles in
+// column-major order, one column per hierarchy vertex. `owner` keeps the
+// storage alive independently of the session.
+struct QuadriFlowFieldView {
+    const double* data = nullptr;
+    int64_t rows = 0;
+    int64_t cols = 0;
+    std::shared_ptr<const void> owner;
+};
+
+// One flat array of a saved session: rows x cols elements of `dtype`
+// ('f' double, 'i' int32, 'q' int64) in storage order. `owner` keeps
+// `data` alive.
+struct QuadriFlowStateArray {
+    std::string name;
+    char dtype = 'f';
+    int64_t rows = 0;
+    int64_t cols = 0;
+    const void* data = nullptr;
+    std::shared_ptr<const void> owner;
+};
+
+// A session as named arrays and scalars, for moving it to another process.
+struct QuadriFlowSessionState {
+    std::vector<QuadriFlowStateArray> arrays;
+    std::vector<std::pair<std::string, double>> scalars;
+};
+
+// Keeps the loaded mesh, hierarchy and solved fields between calls, so
+// interactive previews reuse the hierarchy and a full-quality run can
+// continue from the preview's fields instead of restarting.
+class QuadriFlowSession {
+public:
+    QuadriFlowSession(
+        const double* vertices, int64_t num_vertices,
+        const int* faces, int64_t num_faces,
+        const QuadriFlowOptions& options
+    );
+    // Restore a session saved by save_state(), possibly in another process.
+    // The arrays are copied straight into the solver's storage: the mesh is
+    // not reloaded and the hierarchy not rebuilt. Progress and cancel
+    // callbacks are not part of the state.
+    explicit QuadriFlowSession(const QuadriFlowSessionState& state);
+    ~QuadriFlowSession();
+
+    QuadriFlowSession(const QuadriFlowSession&) = delete;
+    QuadriFlowSession& operator=(const QuadriFlowSession&) = delete;
+
+    // Fast approximate remesh: fields are smoothed on the coarse hierarchy
+    // levels only and quads are read off the coarsest level that still
+    // samples the target lattice, without the flow solve, so a call costs
+    // in proportion to target_faces rather than the input. Faces that do not
+    // close into quads are dropped. The first call (and the first after
+    // run()) also loads the mesh and builds the hierarchy, which does scale
+    // with the input.
+    QuadriFlowResult preview(int target_faces);
+
+    // Full-quality remesh. Continues from the last preview's fields when
+    // target_faces matches the target the hierarchy was built for.
+    QuadriFlowResult run(int target_faces);
+
+    // Hierarchy levels of the current fields; 0 before the first call.
+    int num_levels() const;
+
+    // Finest level the last preview solved, which run() continues from;
+    // -1 if there is none to continue from.
+    int preview_level() const;
+
+    // Zero-copy view of a solver field at a hierarchy level (0 = finest):
+    // "V" vertices, "N" normals, "Q" orientation, "O" position (3 x n) or
+    // "S" scale (2 x n), in the normalized frame (see normalization()).
+    // Views are live: later solves of the same hierarchy show through.
+    // preview() solves only the coarse levels, leaving the finer ones as
+    // they were.
+    // A rebuild (first call after run(), or a new run() target) starts new
+    // storage and leaves existing views on the old one.
+    QuadriFlowFieldView field(const std::string& name, int level) const;
+
+    // Input position = normalized position * scale + offset.
+    void normalization(double offset[3], double* scale) const;
+
+    // The input, options and (once built, until run() consumes it) the
+    // hierarchy with its solved fields. Arrays alias the session's storage
+    // like field() views; only adjacency and phase lists are flattened
+    // into new arrays.
+    QuadriFlowSessionState save_state() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// ---------------------------------------------------------------------------
+// Allocation accounting
+// ---------------------------------------------------------------------------
+
+// True in builds with PYQUADRIFLOW_ALLOC_STATS, where the allocation fields
+// of QuadriFlowStageTiming are filled in.
+bool allocation_accounting_available();
+
+// ---------------------------------------------------------------------------
+// Hardware performance counters
+// ---------------------------------------------------------------------------
+
+// Process-wide switch for per-stage cycles, instructions, last-level cache
+// misses, branch misses and data TLB misses (Linux perf events). Off by default; counters
+// the kernel does not permit are left at -1 in QuadriFlowStageTiming.
+void set_hardware_counters_enabled(bool enabled);
+bool hardware_counters_enabled();
+
+// Whether this process may open a user-space cycle counter.
+bool hardware_counters_available();
+
+// ---------------------------------------------------------------------------
+// Executor
+// ---------------------------------------------------------------------------
+
+// All internal parallelism (seed candidates, batch remeshing) goes through
+// the process-wide executor. The default one runs on the thread pool below;
+// a host application that owns its own scheduler (a TBB task arena, a job
+// system) installs an adapter instead, so the library does not start
+// threads of its own and oversubscribe the cores.
+//
+// The pipeline never waits for anything but its own tasks, and the default
+// parallel_for below runs part of the range on the calling thread, so an
+// executor whose workers are all busy (or that runs tasks inline) slows a
+// call down but cannot deadlock it. The built-in executor overrides it: the
+// caller blocks while the pool's workers run the range (see ThreadPoolRun).
+class QuadriFlowExecutor {
+public:
+    virtual ~QuadriFlowExecutor() = default;
+
+    // Number of tasks that can usefully run at once, including the caller.
+    virtual int concurrency() = 0;
+
+    // Run `task` asynchronously, on any thread. Tasks the pipeline submits
+    // do not throw.
+    virtual void submit(std::function<void()> task) = 0;
+
+    // Call body(i) for every i in [0, n), concurrently where possible, and
+    // return when all calls have returned. The first exception a body
+    // throws is rethrown once all have finished. The default runs one share
+    // of the range on the caller and submit()s up to concurrency() - 1
+    // helper tasks for the rest; helpers that start late find no work.
+    virtual void parallel_for(int n, const std::function<void(int)>& body);
+};
+
+// Install the executor used by subsequent calls (nullptr: the default).
+// Calls already running keep the executor they started with.
+void set_executor(std::shared_ptr<QuadriFlowExecutor> executor);
+std::shared_ptr<QuadriFlowExecutor> get_executor();
+
+// The built-in executor on the library's thread pool.
+std::shared_ptr<QuadriFlowExecutor> default_executor();
+
+// ---------------------------------------------------------------------------
+// Thread pool
+// ---------------------------------------------------------------------------
+
+// The default executor runs on one process-wide pool of worker threads,
+// started on first use and kept warm across calls; with another executor
+// installed it sits idle. After fork() the child starts its own
+// pool on first use.
+
+// Size the pool (num_threads <= 0: one per CPU in the process's affinity
+// mask) and optionally pin each worker to a single CPU, sharing CPUs only
+// when there are more workers than CPUs; otherwise workers are only kept
+// on their NUMA node. Shuts the current pool down; the next parallel call starts the new
+// one.
+void configure_thread_pool(int num_threads, bool pin_threads);
+
+// Stop and join the workers (once calls still using them return). The next
+// parallel call starts a new pool.
+void shutdown_thread_pool();
+
+// ---------------------------------------------------------------------------
+// Huge pages
+// ---------------------------------------------------------------------------
+
+// Process-wide switch for transparent huge pages on large buffers: output
+// arrays, loader storage, seed candidate fields, and the hierarchy, which is
+// collapsed into huge pages after it is built (the "hugepages" stage). On by
+// default; set before a call to compare its runtime and dtlb_misses.
+void set_hugepages_enabled(bool enabled);
+bool hugepages_enabled();
+
+// Whether the kernel provides transparent huge pages (Linux, not "never").
+bool hugepages_available();
+
+// ---------------------------------------------------------------------------
+// Tracing
+// ---------------------------------------------------------------------------
+
+// Process-wide switch for timeline tracing of every stage and sub-stage
+// (hierarchy levels, phase sweeps, restriction, seed candidates) into
+// per-thread ring buffers. Off by default.
+void set_tracing_enabled(bool enabled);
+bool tracing_enabled();
+
+// Events recorded since the last clearing export, as Chrome trace JSON
+// (chrome://tracing, ui.perfetto.dev). Each ring keeps its most recent
+// 16384 events. Export while no remesh is running for a consistent cut.
+std::string export_chrome_trace(bool clear = true);
+
+// ---------------------------------------------------------------------------
+// Cumulative metrics
+// ---------------------------------------------------------------------------
+
+// Histogram of one stage's wall time over all calls. `buckets[i]` counts
+// the observations <= QuadriFlowMetrics::bucket_bounds[i] (cumulative, as
+// in Prometheus); `count` includes those above the last bound.
+struct QuadriFlowStageMetrics {
+    std::string name;
+    uint64_t count;
+    double total_seconds;
+    std::vector<uint64_t> buckets;
+};
+
+// Totals since process start or the last reset_metrics(). Calls are the
+// full remeshes (run_quadriflow, run_quadriflow_seeds, the builder's and
+// session's remesh / run); stages also include session previews.
+struct QuadriFlowMetrics {
+    uint64_t calls;
+    uint64_t failures;            // calls that threw
+    uint64_t input_faces;         // summed over all calls
+    uint64_t output_faces;        // summed over successful calls
+    int64_t peak_memory_bytes;    // process peak resident set seen at call end
+    std::vector<double> bucket_bounds;  // seconds, ascending
+    std::vector<QuadriFlowStageMetrics> stages;  // in order of first use
+};
+
+QuadriFlowMetrics get_metrics();
+
+// Zero every counter. Calls running concurrently may be partly counted.
+void reset_metrics();
+
+// The metrics in Prometheus text exposition format (version 0.0.4).
+std::string export_prometheus_metrics();
+
+// ---------------------------------------------------------------------------
+// Resource estimation (admission control)
+// ---------------------------------------------------------------------------
+
+// Linear cost model coefficients. The defaults are uncalibrated
+// placeholders: order-of-magnitude values derived from the pipeline's
+// per-element storage, not fitted to measured runs. Treat the predictions
+// as relative until the coefficients are refit from runs on the target
+// hardware (the stage timings and memory of real jobs) and passed to
+// estimate_resources().
+struct QuadriFlowCostModel {
+    double base_bytes = 64.0e6;               // allocator arenas, small tables
+    double bytes_per_input_face = 160.0;      // LoadFromArrays vertex map + copies
+    double bytes_per_working_vertex = 1600.0; // parametrizer + hierarchy + extraction
+    double base_seconds = 0.01;
+    double seconds_per_working_face = 6.0e-6; // hierarchy build + field solves
+    double seconds_per_output_face = 2.0e-5;  // index map extraction (max-flow)
+    double seconds_per_boundary_edge = 1.0e-6;
+    double seconds_per_component = 1.0e-3;
+    double adaptive_scale_factor = 1.3;       // applied to the field-solve term
+    double preserve_sharp_factor = 1.2;       // applied to the extraction term
+    double aggressive_sat_factor = 1.5;       // applied to the extraction term
+    double minimum_cost_flow_factor = 3.0;    // applied to the extraction term
+};
+
+struct QuadriFlowResourceEstimate {
+    // Cheap input analysis
+    int64_t num_components;
+    int64_t num_boundary_edges;
+    double boundary_length;     // in input units
+    double surface_area;        // in input units
+    double target_ratio;        // target_faces / num_faces
+    double working_faces;       // faces after upstream's pre-subdivision
+    // Predictions
+    double peak_memory_bytes;
+    double runtime_seconds;
+};
+
+// Predict peak memory and runtime of run_quadriflow() for the given input
+// without running it. O(num_faces) time and memory.
+QuadriFlowResourceEstimate estimate_resources(
+    const double* vertices, int64_t num_vertices,
+    const int* faces, int64_t num_faces,
+    const QuadriFlowOptions& options,
+    const QuadriFlowCostModel& model = QuadriFlowCostModel()
+);
+
 #endif // PYQUADRIFLOW_PIPELINE_H
@@ -0,0 +1,181 @@
+// Approximate quad extraction for interactive previews.
+
+#include "preview_extract.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+
+using namespace qflow;
+
+namespace {
+
+// Preview smoothing stops at the deepest level that still has this many
+// vertices per target quad, so every lattice point is sampled.
+const int kPreviewOversampling = 4;
+
+int FindRoot(std::vector<int>& parent, int i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+inline uint64_t EdgeKey(int a, int b) {
+    return (static_cast<uint64_t>(a) << 32) | static_cast<uint32_t>(b);
+}
+
+} // namespace
+
+int PreviewLevel(const Hierarchy& mRes, int target_faces) {
+    const double min_vertices = (double)kPreviewOversampling * target_faces;
+    int level = 0;
+    while (level + 1 < (int)mRes.mV.size() && mRes.mV[level + 1].cols() >= min_vertices) {
+        ++level;
+    }
+    return level;
+}
+
+void ExtractPreviewMesh(
+    const Hierarchy& mRes, int level, double scale,
+    std::vector<Vector3d>& O_out,
+    std::vector<Vector4i>& F_out
+) {
+    const AdjacentMatrix& adj = mRes.mAdj[level];
+    const MatrixXd& O = mRes.mO[level];
+    const MatrixXd& N = mRes.mN[level];
+    const MatrixXd& Q = mRes.mQ[level];
+    const int n = (int)O.cols();
+    const double merge_dist2 = 0.25 * scale * scale;
+
+    // 1. Merge adjacent vertices that snapped to the same lattice point
+    std::vector<int> parent(n);
+    std::iota(parent.begin(), parent.end(), 0);
+    for (int i = 0; i < n; ++i) {
+        for (const auto& link : adj[i]) {
+            const int j = link.id;
+            if (j <= i) continue;
+            if ((O.col(i) - O.col(j)).squaredNorm() < merge_dist2) {
+                const int a = FindRoot(parent, i), b = FindRoot(parent, j);
+                if (a != b) parent[std::max(a, b)] = std::min(a, b);
+            }
+        }
+    }
+
+    std::vector<int> cluster(n, -1);
+    std::vector<int> representative;
+    std::vector<Vector3d> position, normal;
+    std::vector<int> weight;
+    for (int i = 0; i < n; ++i) {
+        const int root = FindRoot(parent, i);
+        if (cluster[root] == -1) {
+            cluster[root] = (int)representative.size();
+            representative.push_back(i);
+            position.push_back(Vector3d::Zero());
+            normal.push_back(Vector3d::Zero());
+            weight.push_back(0);
+        }
+        const int c = cluster[root];
+        cluster[i] = c;
+        position[c] += O.col(i);
+        normal[c] += N.col(i);
+        weight[c] += 1;
+    }
+    const int num_clusters = (int)representative.size();
+    for (int c = 0; c < num_clusters; ++c) {
+        position[c] /= weight[c];
+        if (normal[c].squaredNorm() > 0) normal[c].normalize();
+    }
+
+    // 2. Lattice edges: cluster pairs one lattice step apart in the local
+    //    frame. Candidate pairs are deduplicated by sorting, not hashing.
+    std::vector<uint64_t> pairs;
+    for (int i = 0; i < n; ++i) {
+        for (const auto& link : adj[i]) {
+            int a = cluster[i], b = cluster[link.id];
+            if (a == b) continue;
+            if (a > b) std::swap(a, b);
+            pairs.push_back(EdgeKey(a, b));
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+    std::vector<std::vector<std::pair<double, int>>> ring(num_clusters);
+    const double inv_scale = 1.0 / scale;
+    for (const uint64_t key : pairs) {
+        const int a = (int)(key >> 32), b = (int)(uint32_t)key;
+        const Vector3d n_a = normal[a];
+        Vector3d q_a = Q.col(representative[a]);
+        q_a = (q_a - n_a * n_a.dot(q_a)).normalized();
+        const Vector3d t_a = n_a.cross(q_a);
+        const Vector3d d = position[b] - position[a];
+        const long dx = std::lround(d.dot(q_a) * inv_scale);
+        const long dy = std::lround(d.dot(t_a) * inv_scale);
+        if (std::abs(dx) + std::abs(dy) != 1) continue;
+
+        ring[a].push_back({0.0, b});
+        ring[b].push_back({0.0, a});
+    }
+
+    // Sort every ring counter-clockwise around the cluster normal
+    for (int c = 0; c < num_clusters; ++c) {
+        const Vector3d n_c = normal[c];
+        Vector3d q_c = Q.col(representative[c]);
+        q_c = (q_c - n_c * n_c.dot(q_c)).normalized();
+        const Vector3d t_c = n_c.cross(q_c);
+        for (auto& entry : ring[c]) {
+            const Vector3d d = position[entry.second] - position[c];
+            entry.first = std::atan2(d.dot(t_c), d.dot(q_c));
+        }
+        std::sort(ring[c].begin(), ring[c].end());
+    }
+
+    // 3. Trace faces: the face left of u->v continues with v->w, where w
+    //    precedes u in v's counter-clockwise ring. Keep closed 4-cycles.
+    //    Directed edge u->v is visited[offset[u] + k] for v = ring[u][k].
+    std::vector<int> offset(num_clusters + 1, 0);
+    for (int c = 0; c < num_clusters; ++c) offset[c + 1] = offset[c] + (int)ring[c].size();
+    std::vector<char> visited(offset[num_clusters], 0);
+    auto find_in_ring = [&](int v, int u) {
+        const auto& r = ring[v];
+        for (size_t k = 0; k < r.size(); ++k) {
+            if (r[k].second == u) return (int)k;
+        }
+        return -1;
+    };
+
+    O_out = std::move(position);
+    F_out.clear();
+    for (int a = 0; a < num_clusters; ++a) {
+        for (size_t start = 0; start < ring[a].size(); ++start) {
+            if (visited[offset[a] + start]) continue;
+            int u = a, k = (int)start;
+
+            int cycle[5];
+            int length = 0;
+            bool closed = false;
+            while (length < 5) {
+                visited[offset[u] + k] = 1;
+                cycle[length++] = u;
+                const int v = ring[u][k].second;
+                const int back = find_in_ring(v, u);
+                if (back == -1) break;
+                const int size = (int)ring[v].size();
+                u = v;
+                k = (back + size - 1) % size;
+                if (u == a) {
+                    closed = true;
+                    break;
+                }
+                if (visited[offset[u] + k]) break;
+            }
+            if (closed && length == 4) {
+                F_out.emplace_back(cycle[0], cycle[1], cycle[2], cycle[3]);
+            }
+        }
+    }
+}
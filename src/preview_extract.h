@@ -0,0 +1,28 @@
+// Approximate quad extraction for interactive previews.
+// Includes QuadriFlow headers — pipeline-side translation units only.
+
+#ifndef PYQUADRIFLOW_PREVIEW_EXTRACT_H
+#define PYQUADRIFLOW_PREVIEW_EXTRACT_H
+
+#include <vector>
+
+#include "hierarchy.hpp"
+
+// Deepest hierarchy level that still oversamples the lattice of a mesh with
+// `target_faces` quads; preview smoothing stops there.
+int PreviewLevel(const qflow::Hierarchy& mRes, int target_faces);
+
+// Read a quad mesh straight off the position field of hierarchy level
+// `level`, without the integer-flow solve of ComputeIndexMap: adjacent
+// vertices whose lattice points coincide are merged, unit lattice offsets
+// become edges and closed 4-cycles of that graph become quads. Faces that
+// do not close into quads (near singularities and boundaries) are dropped.
+// Only the level's own graph is walked, so the cost follows the level size,
+// not the input mesh.
+void ExtractPreviewMesh(
+    const qflow::Hierarchy& mRes, int level, double scale,
+    std::vector<Eigen::Vector3d>& O_out,
+    std::vector<Eigen::Vector4i>& F_out
+);
+
+#endif // PYQUADRIFLOW_PREVIEW_EXTRACT_H
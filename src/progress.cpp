@@ -0,0 +1,74 @@
+// Thread-local progress scopes behind progress.h.
+
+#include "progress.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+thread_local ProgressScope* t_scope = nullptr;
+
+// Nominal share of a full remesh done when each stage starts, from typical
+// stage times; the fraction never moves backwards, and stages not listed
+// (preview extraction, ROI stitching) keep the last one
+struct StageFraction {
+    const char* name;
+    double fraction;
+};
+
+const StageFraction kStageFractions[] = {
+    {"load", 0.0},
+    {"initialize", 0.05},
+    {"hugepages", 0.25},
+    {"coloring", 0.25},
+    {"constraints", 0.25},
+    {"numa", 0.25},
+    {"seed_candidates", 0.25},
+    {"orientations", 0.3},
+    {"scale", 0.45},
+    {"positions", 0.5},
+    {"extraction", 0.75},
+    {"output", 0.95},
+    {"reorder", 0.96},
+    {"encode", 0.98},
+};
+
+} // namespace
+
+ProgressScope::ProgressScope(const QuadriFlowOptions& options)
+    : options_(&options), previous_(t_scope) {
+    t_scope = this;
+}
+
+ProgressScope::~ProgressScope() {
+    t_scope = previous_;
+}
+
+void ProgressScope::Finished() {
+    fraction_ = 1.0;
+    if (options_->progress) options_->progress("done", fraction_);
+}
+
+void ProgressStage(const char* name) {
+    ProgressScope* scope = t_scope;
+    if (!scope) return;
+    const QuadriFlowOptions& options = *scope->options_;
+    if (options.progress) {
+        for (const StageFraction& stage : kStageFractions) {
+            if (std::strcmp(stage.name, name) == 0) {
+                scope->fraction_ = std::max(scope->fraction_, stage.fraction);
+                break;
+            }
+        }
+        options.progress(name, scope->fraction_);
+    }
+    ProgressCheckpoint();
+}
+
+void ProgressCheckpoint() {
+    ProgressScope* scope = t_scope;
+    if (scope && scope->options_->cancel && scope->options_->cancel()) {
+        throw QuadriFlowCancelled();
+    }
+}
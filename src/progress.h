@@ -0,0 +1,42 @@
+// Per-call progress reporting and cooperative cancellation.
+// Pure C++ — no QuadriFlow headers; usable from every pipeline unit.
+//
+// A ProgressScope makes the callbacks of QuadriFlowOptions current on the
+// calling thread for the duration of a call. Stages report through
+// ProgressStage() and long loops poll ProgressCheckpoint(); both cost one
+// thread-local load when no callbacks are set. Worker threads of parallel
+// sections have no scope and are never interrupted.
+
+#ifndef PYQUADRIFLOW_PROGRESS_H
+#define PYQUADRIFLOW_PROGRESS_H
+
+#include "pipeline.h"
+
+class ProgressScope {
+public:
+    explicit ProgressScope(const QuadriFlowOptions& options);
+    ~ProgressScope();
+
+    // Report completion (fraction 1) once the call has succeeded.
+    void Finished();
+
+    ProgressScope(const ProgressScope&) = delete;
+    ProgressScope& operator=(const ProgressScope&) = delete;
+
+private:
+    const QuadriFlowOptions* options_;
+    double fraction_ = 0;
+    ProgressScope* previous_;
+
+    friend void ProgressStage(const char* name);
+    friend void ProgressCheckpoint();
+};
+
+// Stage `name` (a string literal) is starting: report it with the nominal
+// fraction of the call done so far, then poll for cancellation.
+void ProgressStage(const char* name);
+
+// Throw QuadriFlowCancelled if the current call's cancel callback says so.
+void ProgressCheckpoint();
+
+#endif // PYQUADRIFLOW_PROGRESS_H
@@ -5,9 +5,65 @@ Functions
 ---------
 quadriflow_remesh
     Quad-dominant remeshing from a triangle mesh.
+quadriflow_remesh_batch
+    Many meshes in parallel, scheduled per NUMA node.
+MeshBuilder
+    Assemble the input from chunks (tiles), welding their seams.
+Remesher
+    Persistent session: interactive previews, then a full-quality pass.
+encode_mesh, decode_mesh
+    Compact quantized binary format for storing and transferring results.
+enable_hardware_counters
+    Per-stage cycles, IPC and cache / branch / TLB misses in the stats (Linux).
+enable_hugepages
+    Transparent huge pages for large solver buffers (Linux, on by default).
+enable_tracing, export_chrome_trace
+    Timeline tracing of pipeline stages as Chrome trace / Perfetto JSON.
+get_metrics, reset_metrics, prometheus_metrics, serve_metrics
+    Cumulative process-wide telemetry, also as a Prometheus endpoint.
+estimate_resources
+    Predict peak memory and runtime of a remesh before running it.
+configure_thread_pool, shutdown
+    Size, pin or stop the persistent worker pool of parallel remeshing.
 """
 
-from pyquadriflow.quadriflow import quadriflow_remesh
+from pyquadriflow.quadriflow import (
+    MeshBuilder,
+    Remesher,
+    configure_thread_pool,
+    decode_mesh,
+    enable_hardware_counters,
+    enable_hugepages,
+    enable_tracing,
+    encode_mesh,
+    estimate_resources,
+    export_chrome_trace,
+    get_metrics,
+    prometheus_metrics,
+    quadriflow_remesh,
+    quadriflow_remesh_batch,
+    reset_metrics,
+    serve_metrics,
+    shutdown,
+)
 
 __version__ = "0.2.0"
-__all__ = ["quadriflow_remesh"]
+__all__ = [
+    "MeshBuilder",
+    "Remesher",
+    "configure_thread_pool",
+    "decode_mesh",
+    "enable_hardware_counters",
+    "enable_hugepages",
+    "enable_tracing",
+    "encode_mesh",
+    "estimate_resources",
+    "export_chrome_trace",
+    "get_metrics",
+    "prometheus_metrics",
+    "quadriflow_remesh",
+    "quadriflow_remesh_batch",
+    "reset_metrics",
+    "serve_metrics",
+    "shutdown",
+]
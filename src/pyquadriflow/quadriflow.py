@@ -1,9 +1,63 @@
 """QuadriFlow quad-dominant remeshing wrapper."""
 
+import atexit
+import pickle
+import threading
+
 import numpy as np
 from numpy.typing import NDArray
 
+from pyquadriflow._pyquadriflow import MeshBuilder as _MeshBuilder
+from pyquadriflow._pyquadriflow import configure_thread_pool as _configure_thread_pool
+from pyquadriflow._pyquadriflow import decode_mesh as _decode_mesh
+from pyquadriflow._pyquadriflow import encode_mesh as _encode_mesh
+from pyquadriflow._pyquadriflow import Remesher as _Remesher
+from pyquadriflow._pyquadriflow import estimate_resources as _estimate_resources
+from pyquadriflow._pyquadriflow import export_chrome_trace as _export_chrome_trace
+from pyquadriflow._pyquadriflow import export_prometheus_metrics as _export_prometheus_metrics
+from pyquadriflow._pyquadriflow import get_metrics as _get_metrics
+from pyquadriflow._pyquadriflow import hardware_counters_available as _hardware_counters_available
+from pyquadriflow._pyquadriflow import hugepages_available as _hugepages_available
 from pyquadriflow._pyquadriflow import quadriflow_remesh as _quadriflow_remesh
+from pyquadriflow._pyquadriflow import quadriflow_remesh_batch as _quadriflow_remesh_batch
+from pyquadriflow._pyquadriflow import quadriflow_remesh_roi as _quadriflow_remesh_roi
+from pyquadriflow._pyquadriflow import quadriflow_remesh_seeds as _quadriflow_remesh_seeds
+from pyquadriflow._pyquadriflow import reset_metrics as _reset_metrics
+from pyquadriflow._pyquadriflow import set_hardware_counters_enabled as _set_hardware_counters_enabled
+from pyquadriflow._pyquadriflow import set_hugepages_enabled as _set_hugepages_enabled
+from pyquadriflow._pyquadriflow import set_tracing_enabled as _set_tracing_enabled
+from pyquadriflow._pyquadriflow import shutdown_thread_pool as _shutdown_thread_pool
+
+_COST_MODEL_KEYS = frozenset({
+    "base_bytes",
+    "bytes_per_input_face",
+    "bytes_per_working_vertex",
+    "base_seconds",
+    "seconds_per_working_face",
+    "seconds_per_output_face",
+    "seconds_per_boundary_edge",
+    "seconds_per_component",
+    "adaptive_scale_factor",
+    "preserve_sharp_factor",
+    "aggressive_sat_factor",
+    "minimum_cost_flow_factor",
+})
+
+
+def _prepare_mesh(vertices, faces, target_faces):
+    v = np.ascontiguousarray(vertices, dtype=np.float64)
+    f = np.ascontiguousarray(faces, dtype=np.int32)
+
+    if v.ndim != 2 or v.shape[1] != 3:
+        raise ValueError(f"vertices must have shape (N, 3), got {v.shape}")
+    if f.ndim != 2 or f.shape[1] != 3:
+        raise ValueError(f"faces must have shape (M, 3), got {f.shape}")
+    if len(v) == 0 or len(f) == 0:
+        raise ValueError("Input mesh is empty")
+    if target_faces <= 0:
+        raise ValueError(f"target_faces must be positive, got {target_faces}")
+
+    return v, f
 
 
 def quadriflow_remesh(
@@ -17,7 +71,18 @@ def quadriflow_remesh(
     adaptive_scale: bool = False,
     aggressive_sat: bool = False,
     minimum_cost_flow: bool = False,
-) -> tuple[NDArray[np.float64], NDArray[np.int32]]:
+    time_budget_ms: float | None = None,
+    reorder_output: bool = False,
+    encode_position_bits: int | None = None,
+    domain_decomposition: bool = False,
+    balanced_coloring: bool = False,
+    chaotic_relaxation: bool = False,
+    preview: bool = False,
+    seeds: list[int] | None = None,
+    return_all: bool = False,
+    face_mask: NDArray[np.bool_] | None = None,
+    return_stats: bool = False,
+):
     """Quad-dominant remeshing using QuadriFlow.
 
     Takes a triangle mesh and produces a quad-dominant mesh with
@@ -43,6 +108,69 @@ def quadriflow_remesh(
         Use aggressive SAT solver.
     minimum_cost_flow : bool, default False
         Use minimum cost flow solver.
+    time_budget_ms : float, optional
+        Soft deadline for the whole call. When the remaining stages are
+        predicted to overrun, the pipeline degrades gracefully (drops the
+        ``minimum_cost_flow`` / ``aggressive_sat`` refinements, caps the
+        smoothing iterations, then smooths only coarse hierarchy levels)
+        instead of failing. Extraction itself cannot be interrupted.
+    reorder_output : bool, default False
+        Reorder the output for GPU vertex caches and memory locality: quads
+        are emitted in a cache-optimized (Tipsify-style) order and vertices
+        are renumbered in order of first use. Geometry is unchanged.
+    encode_position_bits : int, optional
+        Encode the result natively in the compact quantized format (see
+        :func:`encode_mesh`) with positions quantized to this many bits
+        (1-32) against the input's normalization box, and return the encoded
+        ``bytes`` instead of the ``vertices``/``faces`` arrays. Combine with
+        ``reorder_output`` for the smallest index stream. Not available with
+        ``preview``, ``return_all`` or ``face_mask``.
+    domain_decomposition : bool, default False
+        Smooth the orientation and position fields as spatially compact
+        vertex blocks swept in parallel, exchanging block borders between
+        iterations, instead of colour by colour on one thread. Scales the
+        smoothing stages with the thread pool (see
+        :func:`configure_thread_pool`) on large meshes. The result differs
+        slightly from the default sweeps but does not depend on the number
+        of threads. Not available with ``seeds``.
+    balanced_coloring : bool, default False
+        Recolour the hierarchy levels in parallel and even out the colour
+        classes, so that every phase of the smoothing sweeps is large enough
+        to keep all threads busy. Changes the sweep order, and so the result,
+        but not between thread counts. The phase sizes are reported in the
+        stats either way. Not available with ``seeds``.
+    chaotic_relaxation : bool, default False
+        Hogwild-style smoothing: threads update vertices with no colouring
+        or iteration barriers, reading whatever their neighbours hold at the
+        time. The fastest sweeps, at the cost of determinism: results vary
+        from run to run (and with ``seed`` alone no longer reproduce). Meant
+        for ``preview`` and other low-stakes jobs. Not available with
+        ``seeds``, ``face_mask`` or ``domain_decomposition``.
+    preview : bool, default False
+        Fast approximate remesh: fields are solved on the coarse hierarchy
+        levels only and quads are read off the position field without flow
+        optimization. Faces that do not close into quads are dropped. Use
+        :class:`Remesher` to keep the state between previews.
+    seeds : list of int, optional
+        Best-of-N remeshing. The mesh is loaded and the hierarchy built
+        once; the seed-dependent orientation field is then solved for every
+        seed in parallel threads and scored by its singularity count.
+        Overrides ``seed``. Candidate fields come from a per-seed generator,
+        so ``seeds=[k]`` is reproducible but not identical to ``seed=k``.
+    return_all : bool, default False
+        With ``seeds``, return a list with one ``(vertices, faces, stats)``
+        tuple per seed instead of only the best result. Only the
+        orientation solves are shared and parallel: every seed then runs
+        the scale, position and extraction stages on its own copy of the
+        hierarchy, one seed after the other, so the call costs about one
+        full remesh per seed.
+    face_mask : ndarray of bool, shape (M,), optional
+        Region-of-interest remeshing: only the selected faces are remeshed
+        (to about ``target_faces`` quads) with their border pinned, and the
+        quad patch is stitched to the untouched triangles. The return value
+        then gains a ``triangles`` array, see below.
+    return_stats : bool, default False
+        Also return a stats dict.
 
     Returns
     -------
@@ -50,6 +178,27 @@ def quadriflow_remesh(
         Output quad mesh vertex positions.
     faces : ndarray, shape (L, 4), dtype int32
         Output quad mesh face indices (0-based).
+    encoded : bytes
+        Only with ``encode_position_bits``, in place of ``vertices`` and
+        ``faces``; read it back with :func:`decode_mesh`.
+    triangles : ndarray, shape (T, 3), dtype int32
+        Only with ``face_mask``: the untouched input triangles plus the band
+        stitching them to the quads, indexing the same ``vertices``.
+    stats : dict
+        Only if ``return_stats``. ``stages`` maps stage name to wall seconds,
+        ``total_seconds`` is their sum, ``degradations`` lists the
+        degradations applied to meet ``time_budget_ms``, ``seed`` is the
+        seed used and ``singularities`` the orientation singularity count.
+        ``phase_sizes`` lists, per hierarchy level (finest first), the
+        vertex count of each smoothing phase, and ``working_vertices`` is
+        the vertex count of the solver's working mesh.
+        Builds configured with ``PYQUADRIFLOW_ALLOC_STATS`` add
+        ``allocations``: per stage, the ``allocations``, ``frees``,
+        ``bytes_allocated`` and ``peak_bytes`` of the heap. While
+        :func:`enable_hardware_counters` is on, ``counters`` maps each stage
+        to its ``cycles``, ``instructions``, ``ipc``, ``llc_misses``,
+        ``branch_misses`` and ``dtlb_misses``, the misses also per working-mesh vertex
+        (``*_per_element``); counters the kernel refuses are left out.
 
     Examples
     --------
@@ -59,24 +208,739 @@ def quadriflow_remesh(
     >>> v_quad, f_quad = pyquadriflow.quadriflow_remesh(vertices, faces, target_faces=500)
     >>> print(f"Quads: {f_quad.shape[0]}, vertices: {v_quad.shape[0]}")
     """
+    v, f = _prepare_mesh(vertices, faces, target_faces)
+    if time_budget_ms is not None and time_budget_ms <= 0:
+        raise ValueError(f"time_budget_ms must be positive, got {time_budget_ms}")
+
+    flags = dict(
+        seed=seed,
+        preserve_sharp=preserve_sharp,
+        preserve_boundary=preserve_boundary,
+        adaptive_scale=adaptive_scale,
+        aggressive_sat=aggressive_sat,
+        minimum_cost_flow=minimum_cost_flow,
+        time_budget_ms=time_budget_ms or 0.0,
+        reorder_output=reorder_output,
+    )
+    if encode_position_bits is not None:
+        if not 1 <= encode_position_bits <= 32:
+            raise ValueError(
+                f"encode_position_bits must be in [1, 32], got {encode_position_bits}")
+        if preview or return_all or face_mask is not None:
+            raise ValueError(
+                "encode_position_bits cannot be combined with preview, return_all or face_mask")
+    encode = dict(encode_position_bits=encode_position_bits or 0)
+    solver = dict(domain_decomposition=domain_decomposition, balanced_coloring=balanced_coloring)
+    if any(solver.values()) and seeds is not None:
+        raise ValueError(
+            "domain_decomposition and balanced_coloring cannot be combined with seeds")
+    if chaotic_relaxation and (
+            seeds is not None or face_mask is not None or domain_decomposition):
+        raise ValueError(
+            "chaotic_relaxation cannot be combined with seeds, face_mask or "
+            "domain_decomposition")
+
+    if face_mask is not None:
+        mask = np.ascontiguousarray(face_mask, dtype=np.uint8).reshape(-1)
+        if len(mask) != len(f):
+            raise ValueError(
+                f"face_mask must have one entry per face, got {len(mask)} for {len(f)} faces")
+        if seeds is not None or preview:
+            raise ValueError("face_mask cannot be combined with seeds or preview")
+        del flags["preserve_boundary"]
+        v_out, q_out, t_out, stats = _quadriflow_remesh_roi(
+            v, f, mask, target_faces, **flags, **solver)
+        if return_stats:
+            return v_out, q_out, t_out, stats
+        return v_out, q_out, t_out
+
+    if seeds is not None:
+        seeds = [int(x) for x in seeds]
+        if not seeds:
+            raise ValueError("seeds must not be empty")
+        if preview:
+            raise ValueError("seeds and preview cannot be combined")
+        del flags["seed"]
+        results = _quadriflow_remesh_seeds(
+            v, f, target_faces, seeds, return_all=return_all, **flags, **encode)
+        if return_all:
+            return results
+        v_out, f_out, stats = results[0]
+    elif preview:
+        v_out, f_out, stats = _Remesher(
+            v, f, **flags, **solver,
+            chaotic_relaxation=chaotic_relaxation).preview(target_faces)
+    else:
+        v_out, f_out, stats = _quadriflow_remesh(
+            v, f, target_faces, **flags, **encode, **solver,
+            chaotic_relaxation=chaotic_relaxation)
+    if encode_position_bits is not None:
+        return (v_out, stats) if return_stats else v_out
+    if return_stats:
+        return v_out, f_out, stats
+    return v_out, f_out
+
+
+def quadriflow_remesh_batch(
+    meshes,
+    target_faces: int,
+    *,
+    max_workers: int | None = None,
+    seed: int = 0,
+    preserve_sharp: bool = False,
+    preserve_boundary: bool = False,
+    adaptive_scale: bool = False,
+    aggressive_sat: bool = False,
+    minimum_cost_flow: bool = False,
+    time_budget_ms: float | None = None,
+    reorder_output: bool = False,
+    return_stats: bool = False,
+):
+    """Remesh many independent meshes with the same options in parallel.
+
+    Each mesh runs the full pipeline on one worker of the thread pool (see
+    :func:`configure_thread_pool`). On multi-socket (NUMA) machines the
+    workers sit on sockets in proportion to their cores and the meshes are
+    dealt to per-socket queues, largest first, so every mesh is copied in
+    and solved from its socket's local memory; a socket that runs out of
+    work takes the others' leftovers.
+
+    Parameters
+    ----------
+    meshes : iterable of (vertices, faces)
+        Input triangle meshes, as for :func:`quadriflow_remesh`.
+    target_faces : int
+        Target number of quad faces of every output mesh.
+    max_workers : int, optional
+        Worker threads; one per CPU this process may use by default. Every worker holds a whole
+        remesh in memory, so lower it for large meshes.
+    seed, preserve_sharp, preserve_boundary, adaptive_scale, aggressive_sat, minimum_cost_flow, time_budget_ms, reorder_output
+        As for :func:`quadriflow_remesh`, applied to every mesh.
+    return_stats : bool, default False
+        Also return each mesh's stats; ``stats["numa_node"]`` is the node
+        it ran on.
+
+    Returns
+    -------
+    results : list
+        One ``(vertices, faces)`` tuple per mesh in input order, or
+        ``(vertices, faces, stats)`` with ``return_stats``. If any mesh
+        fails, no further meshes are started and its error is raised.
+    """
+    prepared = [_prepare_mesh(v, f, target_faces) for v, f in meshes]
+    if max_workers is not None and max_workers <= 0:
+        raise ValueError(f"max_workers must be positive, got {max_workers}")
+    if time_budget_ms is not None and time_budget_ms <= 0:
+        raise ValueError(f"time_budget_ms must be positive, got {time_budget_ms}")
+
+    results = _quadriflow_remesh_batch(
+        [v for v, _ in prepared],
+        [f for _, f in prepared],
+        target_faces,
+        max_workers=max_workers or 0,
+        seed=seed,
+        preserve_sharp=preserve_sharp,
+        preserve_boundary=preserve_boundary,
+        adaptive_scale=adaptive_scale,
+        aggressive_sat=aggressive_sat,
+        minimum_cost_flow=minimum_cost_flow,
+        time_budget_ms=time_budget_ms or 0.0,
+        reorder_output=reorder_output,
+    )
+    if return_stats:
+        return [tuple(r) for r in results]
+    return [(v, f) for v, f, _ in results]
+
+
+class Remesher:
+    """Persistent remeshing session for interactive use.
+
+    Loads the mesh once and keeps the QuadriFlow hierarchy and solved fields
+    between calls. :meth:`preview` reuses the hierarchy for any
+    ``target_faces`` (e.g. while a slider moves); :meth:`remesh` produces the
+    full-quality result and continues from the last preview's fields when
+    the target is the one the hierarchy was built for (the first target
+    requested), instead of restarting.
+
+    Parameters
+    ----------
+    vertices : ndarray, shape (N, 3)
+        Input triangle mesh vertex positions.
+    faces : ndarray, shape (M, 3)
+        Input triangle mesh face indices (0-based).
+    **flags
+        ``seed``, ``preserve_sharp``, ``preserve_boundary``,
+        ``adaptive_scale``, ``aggressive_sat``, ``minimum_cost_flow``,
+        ``time_budget_ms``, ``reorder_output``, ``domain_decomposition``,
+        ``balanced_coloring`` and ``chaotic_relaxation``, as for
+        :func:`quadriflow_remesh`; they apply to :meth:`preview` and
+        :meth:`remesh` alike.
+
+    Examples
+    --------
+    >>> r = pyquadriflow.Remesher(vertices, faces)
+    >>> v, f = r.preview(target_faces=500)   # coarse fields, no flow solve
+    >>> v, f = r.remesh(target_faces=500)    # refines the preview's fields
+
+    Calls release the GIL while they compute; calls on the same session
+    from several threads run one at a time.
+    """
+
+    def __init__(
+        self,
+        vertices: NDArray[np.float64],
+        faces: NDArray[np.int32],
+        *,
+        seed: int = 0,
+        preserve_sharp: bool = False,
+        preserve_boundary: bool = False,
+        adaptive_scale: bool = False,
+        aggressive_sat: bool = False,
+        minimum_cost_flow: bool = False,
+        time_budget_ms: float | None = None,
+        reorder_output: bool = False,
+        domain_decomposition: bool = False,
+        balanced_coloring: bool = False,
+        chaotic_relaxation: bool = False,
+    ):
+        v, f = _prepare_mesh(vertices, faces, 1)
+        if chaotic_relaxation and domain_decomposition:
+            raise ValueError(
+                "chaotic_relaxation cannot be combined with domain_decomposition")
+        self._lock = threading.Lock()
+        self._native = _Remesher(
+            v, f,
+            seed=seed,
+            preserve_sharp=preserve_sharp,
+            preserve_boundary=preserve_boundary,
+            adaptive_scale=adaptive_scale,
+            aggressive_sat=aggressive_sat,
+            minimum_cost_flow=minimum_cost_flow,
+            time_budget_ms=time_budget_ms or 0.0,
+            reorder_output=reorder_output,
+            domain_decomposition=domain_decomposition,
+            balanced_coloring=balanced_coloring,
+            chaotic_relaxation=chaotic_relaxation,
+        )
+
+    def preview(self, target_faces: int, *, return_stats: bool = False):
+        """Approximate quad mesh from the coarse hierarchy levels.
+
+        Costs in proportion to ``target_faces``, not the input size, except
+        on the first call (and the first after :meth:`remesh`), which also
+        loads the mesh and builds the hierarchy.
+        """
+        if target_faces <= 0:
+            raise ValueError(f"target_faces must be positive, got {target_faces}")
+        with self._lock:
+            v_out, f_out, stats = self._native.preview(target_faces)
+        return (v_out, f_out, stats) if return_stats else (v_out, f_out)
+
+    def remesh(self, target_faces: int, *, return_stats: bool = False):
+        """Full-quality quad mesh, continuing from the preview's fields."""
+        if target_faces <= 0:
+            raise ValueError(f"target_faces must be positive, got {target_faces}")
+        with self._lock:
+            v_out, f_out, stats = self._native.run(target_faces)
+        return (v_out, f_out, stats) if return_stats else (v_out, f_out)
+
+    _FIELDS = ("V", "N", "Q", "O", "S")
+
+    @property
+    def num_levels(self) -> int:
+        """Hierarchy levels of the current fields (0 before the first call)."""
+        with self._lock:
+            return self._native.num_levels
+
+    @property
+    def preview_level(self) -> int | None:
+        """Finest level the last preview solved, or None.
+
+        :meth:`remesh` at the preview's target starts from this level's
+        fields and only refines the finer levels.
+        """
+        with self._lock:
+            level = self._native.preview_level
+        return level if level >= 0 else None
+
+    def field(self, name: str, level: int = 0) -> NDArray[np.float64]:
+        """Read-only, zero-copy view of a solver field.
+
+        Parameters
+        ----------
+        name : {"V", "N", "Q", "O", "S"}
+            Hierarchy vertices, normals, orientation field, position field
+            (all shape ``(n, 3)``) or the anisotropic scale (``(n, 2)``).
+        level : int, default 0
+            Hierarchy level, 0 being the finest.
+
+        The array maps the solver's storage directly and keeps it alive. It
+        is live: later :meth:`preview` / :meth:`remesh` solves on the same
+        hierarchy show through; :meth:`preview` only solves the coarse
+        levels. After a rebuild (the call following :meth:`remesh`, or a
+        new target) it keeps showing the old state.
+        Positions are in the normalized frame, see :attr:`normalization`.
+        """
+        if name not in self._FIELDS:
+            raise ValueError(f"name must be one of {self._FIELDS}, got {name!r}")
+        with self._lock:
+            num_levels = self._native.num_levels
+            if not 0 <= level < num_levels:
+                raise ValueError(f"level must be in [0, {num_levels}), got {level}")
+            return self._native.field(name, level)
+
+    @property
+    def normalization(self) -> tuple[tuple[float, float, float], float]:
+        """``(offset, scale)``; input position = normalized * scale + offset."""
+        with self._lock:
+            return self._native.normalization
+
+    def __reduce_ex__(self, protocol):
+        """Pickle the session, including its hierarchy and solved fields.
+
+        With protocol 5 the solver arrays are exported as out-of-band
+        :class:`pickle.PickleBuffer` views of the session's storage: with a
+        ``buffer_callback`` (shared-memory transports) they are not copied
+        into the pickle. Unpickling copies them straight into the solver,
+        so a worker continues from the fields without reloading the mesh or
+        rebuilding the hierarchy.
+        """
+        with self._lock:
+            scalars, arrays = self._native.save_state()
+        layout = [(name, dtype, rows, cols) for name, dtype, rows, cols, _ in arrays]
+        if protocol >= 5:
+            buffers = [pickle.PickleBuffer(data) for *_, data in arrays]
+        else:
+            buffers = [data.tobytes() for *_, data in arrays]
+        return _restore_remesher, (scalars, layout, *buffers)
+
+
+def _restore_remesher(scalars, layout, *buffers):
+    arrays = [
+        (name, dtype, rows, cols, np.frombuffer(data, dtype=np.uint8))
+        for (name, dtype, rows, cols), data in zip(layout, buffers)
+    ]
+    remesher = Remesher.__new__(Remesher)
+    remesher._lock = threading.Lock()
+    remesher._native = _Remesher.from_state(scalars, arrays)
+    return remesher
+
+
+class MeshBuilder:
+    """Assemble the input mesh from chunks without concatenating them.
+
+    Meant for meshes produced in tiles: each chunk is appended directly into
+    the pipeline's loader storage, so there is no concatenated NumPy copy
+    and no second copy at load time. Vertices on a chunk's open border are
+    welded to border vertices of earlier chunks through a spatial hash as
+    the chunk arrives; vertices inside a chunk are never merged.
+
+    Parameters
+    ----------
+    weld_tolerance : float, default 0.0
+        Border vertices closer than this are welded. 0 welds only
+        bit-identical positions, which is what tiles sharing seam vertices
+        produce.
+
+    Examples
+    --------
+    >>> builder = pyquadriflow.MeshBuilder(weld_tolerance=1e-6)
+    >>> for tile_verts, tile_faces in tiles:
+    ...     builder.add_chunk(tile_verts, tile_faces)
+    >>> v, f = builder.remesh(target_faces=5000)
+    """
+
+    def __init__(self, weld_tolerance: float = 0.0):
+        if weld_tolerance < 0:
+            raise ValueError(f"weld_tolerance must be non-negative, got {weld_tolerance}")
+        self._lock = threading.Lock()
+        self._native = _MeshBuilder(float(weld_tolerance))
+
+    def add_chunk(self, vertices: NDArray[np.float64], faces: NDArray[np.int32]) -> None:
+        """Append a triangle chunk; ``faces`` index the chunk's own ``vertices``."""
+        v = np.ascontiguousarray(vertices, dtype=np.float64)
+        f = np.ascontiguousarray(faces, dtype=np.int32)
+        if v.ndim != 2 or v.shape[1] != 3:
+            raise ValueError(f"vertices must have shape (N, 3), got {v.shape}")
+        if f.ndim != 2 or f.shape[1] != 3:
+            raise ValueError(f"faces must have shape (M, 3), got {f.shape}")
+        if len(v) == 0 or len(f) == 0:
+            return
+        with self._lock:
+            self._native.add_chunk(v, f)
+
+    @property
+    def num_vertices(self) -> int:
+        """Vertices accumulated so far, after welding."""
+        with self._lock:
+            return self._native.num_vertices
+
+    @property
+    def num_faces(self) -> int:
+        """Faces accumulated so far."""
+        with self._lock:
+            return self._native.num_faces
+
+    def remesh(
+        self,
+        target_faces: int,
+        *,
+        seed: int = 0,
+        preserve_sharp: bool = False,
+        preserve_boundary: bool = False,
+        adaptive_scale: bool = False,
+        aggressive_sat: bool = False,
+        minimum_cost_flow: bool = False,
+        time_budget_ms: float | None = None,
+        reorder_output: bool = False,
+        domain_decomposition: bool = False,
+        balanced_coloring: bool = False,
+        return_stats: bool = False,
+    ):
+        """Remesh the accumulated mesh, as :func:`quadriflow_remesh`.
+
+        The accumulated storage is handed to the pipeline, so the builder is
+        empty afterwards.
+        """
+        if target_faces <= 0:
+            raise ValueError(f"target_faces must be positive, got {target_faces}")
+        if time_budget_ms is not None and time_budget_ms <= 0:
+            raise ValueError(f"time_budget_ms must be positive, got {time_budget_ms}")
+        with self._lock:
+            if self._native.num_faces == 0:
+                raise ValueError("Input mesh is empty")
+            v_out, f_out, stats = self._native.remesh(
+                target_faces,
+                seed=seed,
+                preserve_sharp=preserve_sharp,
+                preserve_boundary=preserve_boundary,
+                adaptive_scale=adaptive_scale,
+                aggressive_sat=aggressive_sat,
+                minimum_cost_flow=minimum_cost_flow,
+                time_budget_ms=time_budget_ms or 0.0,
+                reorder_output=reorder_output,
+                domain_decomposition=domain_decomposition,
+                balanced_coloring=balanced_coloring,
+            )
+        return (v_out, f_out, stats) if return_stats else (v_out, f_out)
+
+
+def encode_mesh(
+    vertices: NDArray[np.float64],
+    faces: NDArray[np.int32],
+    *,
+    position_bits: int = 16,
+) -> bytes:
+    """Encode a quad mesh in the compact quantized binary format.
+
+    Positions are quantized to ``position_bits`` (1-32) per coordinate
+    against the mesh bounding box and stored as fixed-width ``uint16`` (up
+    to 16 bits) or ``uint32`` words at a fixed offset, so a memory-mapped
+    file can be read without decoding. Quad indices are stored as zigzag
+    varints of the difference to the previous index, which is compact for
+    meshes written with ``reorder_output=True``.
+
+    Parameters
+    ----------
+    vertices : ndarray, shape (K, 3)
+        Quad mesh vertex positions.
+    faces : ndarray, shape (L, 4)
+        Quad face indices (0-based).
+    position_bits : int, default 16
+        Bits per quantized coordinate.
+
+    Returns
+    -------
+    encoded : bytes
+    """
     v = np.ascontiguousarray(vertices, dtype=np.float64)
     f = np.ascontiguousarray(faces, dtype=np.int32)
-
     if v.ndim != 2 or v.shape[1] != 3:
-        raise ValueError(f"vertices must have shape (N, 3), got {v.shape}")
-    if f.ndim != 2 or f.shape[1] != 3:
-        raise ValueError(f"faces must have shape (M, 3), got {f.shape}")
-    if len(v) == 0 or len(f) == 0:
-        raise ValueError("Input mesh is empty")
-    if target_faces <= 0:
-        raise ValueError(f"target_faces must be positive, got {target_faces}")
+        raise ValueError(f"vertices must have shape (K, 3), got {v.shape}")
+    if f.ndim != 2 or f.shape[1] != 4:
+        raise ValueError(f"faces must have shape (L, 4), got {f.shape}")
+    if not 1 <= position_bits <= 32:
+        raise ValueError(f"position_bits must be in [1, 32], got {position_bits}")
+    if len(f) and (f.min() < 0 or f.max() >= len(v)):
+        raise ValueError("faces index out of range")
+    return _encode_mesh(v, f, position_bits)
+
+
+def decode_mesh(data) -> tuple[NDArray[np.float64], NDArray[np.int32]]:
+    """Decode a mesh written by :func:`encode_mesh` or ``encode_position_bits``.
+
+    ``data`` may be any buffer: ``bytes``, an ``mmap.mmap`` or a
+    ``np.memmap`` of a file, which is read in place without a copy.
+
+    Returns
+    -------
+    vertices : ndarray, shape (K, 3), dtype float64
+    faces : ndarray, shape (L, 4), dtype int32
+    """
+    return _decode_mesh(np.frombuffer(data, dtype=np.uint8))
+
+
+def estimate_resources(
+    vertices: NDArray[np.float64],
+    faces: NDArray[np.int32],
+    target_faces: int,
+    *,
+    preserve_sharp: bool = False,
+    preserve_boundary: bool = False,
+    adaptive_scale: bool = False,
+    aggressive_sat: bool = False,
+    minimum_cost_flow: bool = False,
+    cost_model: dict[str, float] | None = None,
+) -> dict[str, float]:
+    """Predict peak memory and runtime of :func:`quadriflow_remesh`.
+
+    Runs only cheap O(M) analysis of the input (surface area, connected
+    components, boundary edges, face count after QuadriFlow's
+    pre-subdivision) and feeds it through a linear cost model, so a
+    scheduler can place jobs before running them.
 
-    return _quadriflow_remesh(
+    The default coefficients are uncalibrated placeholders, derived from
+    per-element storage rather than fitted to measured runs: the predicted
+    memory and runtime are good for ranking jobs, not as absolute numbers.
+    Refit them from runs on the target hardware and pass them as
+    ``cost_model`` before relying on the absolute values.
+
+    Parameters
+    ----------
+    vertices : ndarray, shape (N, 3)
+        Input triangle mesh vertex positions.
+    faces : ndarray, shape (M, 3)
+        Input triangle mesh face indices (0-based).
+    target_faces : int
+        Target number of quad faces in the output.
+    preserve_sharp, preserve_boundary, adaptive_scale, aggressive_sat, minimum_cost_flow : bool
+        Same flags as :func:`quadriflow_remesh`.
+    cost_model : dict, optional
+        Coefficient overrides, e.g. refit from measured runs on the target
+        hardware. Keys: ``base_bytes``, ``bytes_per_input_face``,
+        ``bytes_per_working_vertex``, ``base_seconds``,
+        ``seconds_per_working_face``, ``seconds_per_output_face``,
+        ``seconds_per_boundary_edge``, ``seconds_per_component``,
+        ``adaptive_scale_factor``, ``preserve_sharp_factor``,
+        ``aggressive_sat_factor``, ``minimum_cost_flow_factor``.
+
+    Returns
+    -------
+    estimate : dict
+        ``num_components``, ``num_boundary_edges``, ``boundary_length``,
+        ``surface_area``, ``target_ratio``, ``working_faces``,
+        ``peak_memory_bytes`` and ``runtime_seconds``.
+    """
+    v, f = _prepare_mesh(vertices, faces, target_faces)
+
+    cost_model = dict(cost_model or {})
+    unknown = set(cost_model) - _COST_MODEL_KEYS
+    if unknown:
+        raise ValueError(f"unknown cost_model keys: {sorted(unknown)}")
+
+    return _estimate_resources(
         v, f, target_faces,
-        seed=seed,
         preserve_sharp=preserve_sharp,
         preserve_boundary=preserve_boundary,
         adaptive_scale=adaptive_scale,
         aggressive_sat=aggressive_sat,
         minimum_cost_flow=minimum_cost_flow,
+        cost_model={k: float(x) for k, x in cost_model.items()},
     )
+
+
+def get_metrics() -> dict:
+    """Cumulative metrics over every remesh in this process.
+
+    Counted natively with lock-free atomics, so nothing needs to wrap the
+    calls. A call is a full remesh (:func:`quadriflow_remesh`,
+    :meth:`Remesher.run`, :meth:`MeshBuilder.remesh`); ``Remesher.preview``
+    only contributes stage times.
+
+    Returns
+    -------
+    metrics : dict
+        ``calls``, ``failures`` (calls that raised), ``input_faces`` and
+        ``output_faces`` (summed), ``peak_memory_bytes`` (process peak
+        resident set seen at the end of a call) and ``stages``: per stage
+        name, ``count``, ``total_seconds`` and ``buckets``, a list of
+        ``(upper_bound_seconds, cumulative_count)``.
+    """
+    return _get_metrics()
+
+
+def reset_metrics() -> None:
+    """Zero the cumulative metrics (e.g. after a scrape window)."""
+    _reset_metrics()
+
+
+def prometheus_metrics() -> str:
+    """The cumulative metrics in Prometheus text exposition format.
+
+    Counters ``quadriflow_calls_total``, ``quadriflow_failures_total``,
+    ``quadriflow_input_faces_total``, ``quadriflow_output_faces_total``,
+    the gauge ``quadriflow_peak_memory_bytes`` and the histogram
+    ``quadriflow_stage_seconds`` labelled by ``stage``.
+    """
+    return _export_prometheus_metrics()
+
+
+def serve_metrics(port: int = 9464, host: str = "127.0.0.1"):
+    """Serve :func:`prometheus_metrics` over HTTP for scraping.
+
+    Starts a daemon thread answering ``GET /metrics``; remeshing releases
+    the GIL, so scrapes are answered while a remesh runs. Binds to localhost
+    by default; pass ``host="0.0.0.0"`` only on trusted networks.
+
+    Parameters
+    ----------
+    port : int, default 9464
+        TCP port; 0 picks a free one (see ``server.server_address``).
+    host : str, default "127.0.0.1"
+        Interface to bind.
+
+    Returns
+    -------
+    server : http.server.ThreadingHTTPServer
+        Call ``server.shutdown()`` to stop it.
+    """
+    import http.server
+
+    class Handler(http.server.BaseHTTPRequestHandler):
+        def do_GET(self):
+            if self.path.split("?")[0] != "/metrics":
+                self.send_error(404)
+                return
+            body = _export_prometheus_metrics().encode("utf-8")
+            self.send_response(200)
+            self.send_header("Content-Type", "text/plain; version=0.0.4; charset=utf-8")
+            self.send_header("Content-Length", str(len(body)))
+            self.end_headers()
+            self.wfile.write(body)
+
+        def log_message(self, format, *args):
+            pass
+
+    server = http.server.ThreadingHTTPServer((host, port), Handler)
+    server.daemon_threads = True
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+    return server
+
+
+def enable_hardware_counters(enabled: bool = True) -> bool:
+    """Turn process-wide per-stage hardware performance counters on or off.
+
+    While enabled, every pipeline stage reads cycles, instructions,
+    last-level cache misses, branch misses and data TLB misses (user space, including its
+    worker threads) through Linux perf events, reported under
+    ``stats["counters"]``. Where perf events are not permitted (see
+    ``/proc/sys/kernel/perf_event_paranoid``), not supported by the CPU or
+    virtual machine, or not on Linux, the stats simply omit them.
+
+    Returns
+    -------
+    available : bool
+        Whether this process can open the counters at all.
+    """
+    _set_hardware_counters_enabled(bool(enabled))
+    return _hardware_counters_available()
+
+
+def enable_hugepages(enabled: bool = True) -> bool:
+    """Turn process-wide transparent huge pages for large buffers on or off.
+
+    On by default. Output arrays, loader storage and seed candidate fields
+    of 4 MB and more start on 2 MB boundaries advised for huge pages, and
+    the solver hierarchy is collapsed into huge pages once it is built
+    (the ``hugepages`` stage). This cuts TLB misses of the solver's
+    neighbour gathers on large meshes; compare ``dtlb_misses`` and stage
+    times with :func:`enable_hardware_counters` to measure it.
+
+    Returns
+    -------
+    available : bool
+        Whether the kernel provides transparent huge pages (Linux, with
+        ``/sys/kernel/mm/transparent_hugepage/enabled`` not ``never``).
+    """
+    _set_hugepages_enabled(bool(enabled))
+    return _hugepages_available()
+
+
+def configure_thread_pool(num_threads: int | None = None, *, pin_threads: bool = False) -> None:
+    """Size the process-wide worker pool used by parallel remeshing.
+
+    Seed candidates and :func:`quadriflow_remesh_batch` run on one pool of
+    worker threads that is started on the first parallel call and kept
+    warm across calls. The current pool is shut down; the next parallel
+    call starts the new one. Results do not depend on the pool, except
+    with ``chaotic_relaxation``, where they vary with the thread count and
+    timing.
+
+    A process forked while the pool exists (``multiprocessing`` with the
+    ``fork`` start method) starts its own pool on first use.
+
+    Parameters
+    ----------
+    num_threads : int, optional
+        Worker count. Default: one per CPU this process may use, as
+        limited by ``taskset`` or a cgroup cpuset.
+    pin_threads : bool, default False
+        Pin each worker to a single CPU; workers share CPUs only when there
+        are more of them than CPUs. Otherwise workers are only kept on
+        their NUMA node and the kernel may move them between its cores.
+    """
+    if num_threads is not None and num_threads <= 0:
+        raise ValueError(f"num_threads must be positive, got {num_threads}")
+    _configure_thread_pool(num_threads or 0, bool(pin_threads))
+
+
+def shutdown() -> None:
+    """Stop and join the worker pool's threads.
+
+    Called automatically at interpreter exit. Remeshing after it is fine:
+    the next parallel call starts a new pool.
+    """
+    _shutdown_thread_pool()
+
+
+# Join the workers before interpreter teardown rather than from the
+# library's static destructors
+atexit.register(shutdown)
+
+
+def enable_tracing(enabled: bool = True) -> None:
+    """Turn process-wide timeline tracing on or off.
+
+    While enabled, every pipeline stage and sub-stage (hierarchy levels,
+    phase sweeps, seed candidates) records a trace event into a lock-free
+    per-thread ring buffer. While disabled the instrumentation costs a
+    single branch per scope. Read the events with
+    :func:`export_chrome_trace`.
+    """
+    _set_tracing_enabled(bool(enabled))
+
+
+def export_chrome_trace(path=None, *, clear: bool = True) -> str:
+    """Export recorded trace events as Chrome trace JSON.
+
+    Load the result in ``chrome://tracing`` or https://ui.perfetto.dev to
+    see per-thread occupancy. Each thread ring keeps its most recent 16384
+    events; call this between remeshes for a consistent snapshot.
+
+    Parameters
+    ----------
+    path : str or path-like, optional
+        Also write the JSON to this file.
+    clear : bool, default True
+        Drop the exported events, so the next export only has new ones.
+
+    Returns
+    -------
+    trace : str
+        The JSON document.
+    """
+    trace = _export_chrome_trace(clear)
+    if path is not None:
+        with open(path, "w", encoding="utf-8") as f:
+            f.write(trace)
+    return trace
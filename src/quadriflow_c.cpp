@@ -0,0 +1,246 @@
+// C ABI behind quadriflow_c.h: argument checks, exception-to-status
+// translation and the opaque result handle over pipeline.h.
+
+#include "quadriflow_c.h"
+
+#include "pipeline.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+static_assert(sizeof(int) == sizeof(int32_t), "face indices are passed through as int32_t");
+static_assert(QF_DEGRADE_SKIP_MINIMUM_COST_FLOW == DEGRADE_SKIP_MINIMUM_COST_FLOW &&
+              QF_DEGRADE_SKIP_AGGRESSIVE_SAT == DEGRADE_SKIP_AGGRESSIVE_SAT &&
+              QF_DEGRADE_FEWER_ITERATIONS == DEGRADE_FEWER_ITERATIONS &&
+              QF_DEGRADE_COARSE_LEVELS_ONLY == DEGRADE_COARSE_LEVELS_ONLY,
+              "degradation bits are passed through unchanged");
+
+struct qf_result {
+    QuadriFlowResult result;
+};
+
+namespace {
+
+thread_local std::string t_last_error;
+
+qf_status Fail(qf_status status, const char* message) {
+    t_last_error = message;
+    return status;
+}
+
+// Run `fn`, mapping every exception to a status: nothing may unwind
+// through the C boundary
+template <typename Fn>
+qf_status Guard(const Fn& fn) {
+    try {
+        t_last_error.clear();
+        return fn();
+    } catch (const QuadriFlowCancelled& e) {
+        return Fail(QF_ERROR_CANCELLED, e.what());
+    } catch (const std::bad_alloc&) {
+        return Fail(QF_ERROR_OUT_OF_MEMORY, "out of memory");
+    } catch (const std::exception& e) {
+        return Fail(QF_ERROR_FAILED, e.what());
+    } catch (...) {
+        return Fail(QF_ERROR_FAILED, "unknown error");
+    }
+}
+
+// Fields present in a caller's qf_options, which may predate later fields
+#define QF_HAS_FIELD(options, field) \
+    ((options)->struct_size >= offsetof(qf_options, field) + sizeof((options)->field))
+
+QuadriFlowOptions ConvertOptions(const qf_options& in) {
+    QuadriFlowOptions out;
+    out.target_faces = in.target_faces;
+    out.seed = in.seed;
+    out.preserve_sharp = in.preserve_sharp != 0;
+    out.preserve_boundary = in.preserve_boundary != 0;
+    out.adaptive_scale = in.adaptive_scale != 0;
+    out.aggressive_sat = in.aggressive_sat != 0;
+    out.minimum_cost_flow = in.minimum_cost_flow != 0;
+    out.reorder_output = in.reorder_output != 0;
+    out.encode_position_bits = in.encode_position_bits;
+    out.time_budget_ms = in.time_budget_ms;
+    if (QF_HAS_FIELD(&in, domain_decomposition)) {
+        out.domain_decomposition = in.domain_decomposition != 0;
+    }
+    if (QF_HAS_FIELD(&in, balanced_coloring)) {
+        out.balanced_coloring = in.balanced_coloring != 0;
+    }
+    if (QF_HAS_FIELD(&in, chaotic_relaxation)) {
+        out.chaotic_relaxation = in.chaotic_relaxation != 0;
+    }
+    void* user_data = in.user_data;
+    if (in.progress) {
+        const qf_progress_fn progress = in.progress;
+        out.progress = [progress, user_data](const char* stage, double fraction) {
+            progress(stage, fraction, user_data);
+        };
+    }
+    if (in.cancel) {
+        const qf_cancel_fn cancel = in.cancel;
+        out.cancel = [cancel, user_data]() { return cancel(user_data) != 0; };
+    }
+    return out;
+}
+
+} // namespace
+
+extern "C" {
+
+uint32_t qf_api_version(void) {
+    return QF_API_VERSION;
+}
+
+const char* qf_status_string(qf_status status) {
+    switch (status) {
+    case QF_OK: return "ok";
+    case QF_ERROR_INVALID_ARGUMENT: return "invalid argument";
+    case QF_ERROR_OUT_OF_MEMORY: return "out of memory";
+    case QF_ERROR_CANCELLED: return "cancelled";
+    case QF_ERROR_BUFFER_TOO_SMALL: return "buffer too small";
+    case QF_ERROR_FAILED: return "failed";
+    }
+    return "unknown status";
+}
+
+const char* qf_last_error(void) {
+    return t_last_error.c_str();
+}
+
+void qf_options_init_sized(qf_options* options, size_t struct_size) {
+    if (!options || struct_size < sizeof(options->struct_size)) return;
+    struct_size = std::min(struct_size, sizeof(qf_options));
+    std::memset(options, 0, struct_size);
+    options->struct_size = (uint32_t)struct_size;
+}
+
+// Callers built against version 1 have its qf_options and no size to pass
+void (qf_options_init)(qf_options* options) {
+    qf_options_init_sized(options, offsetof(qf_options, domain_decomposition));
+}
+
+qf_status qf_remesh(
+    const double* vertices, int64_t num_vertices,
+    const int32_t* faces, int64_t num_faces,
+    const qf_options* options,
+    qf_result** result
+) {
+    if (!result) return Fail(QF_ERROR_INVALID_ARGUMENT, "result must not be NULL");
+    *result = nullptr;
+    if (!vertices || !faces) return Fail(QF_ERROR_INVALID_ARGUMENT, "mesh arrays must not be NULL");
+    if (num_vertices <= 0 || num_faces <= 0) return Fail(QF_ERROR_INVALID_ARGUMENT, "Input mesh is empty");
+    if (!options || !QF_HAS_FIELD(options, user_data)) {
+        return Fail(QF_ERROR_INVALID_ARGUMENT, "options must be set up with qf_options_init");
+    }
+    if (options->target_faces <= 0) {
+        return Fail(QF_ERROR_INVALID_ARGUMENT, "target_faces must be positive");
+    }
+    if (options->encode_position_bits < 0 || options->encode_position_bits > 32) {
+        return Fail(QF_ERROR_INVALID_ARGUMENT, "encode_position_bits must be in [0, 32]");
+    }
+    for (int64_t i = 0; i < num_faces * 3; ++i) {
+        if (faces[i] < 0 || faces[i] >= num_vertices) {
+            return Fail(QF_ERROR_INVALID_ARGUMENT, "face index out of range");
+        }
+    }
+
+    return Guard([&]() {
+        const QuadriFlowOptions converted = ConvertOptions(*options);
+        qf_result* handle = new qf_result{
+            run_quadriflow(vertices, num_vertices, faces, num_faces, converted)};
+        *result = handle;
+        return QF_OK;
+    });
+}
+
+void qf_result_free(qf_result* result) {
+    delete result;
+}
+
+int64_t qf_result_num_vertices(const qf_result* result) {
+    return result ? result->result.num_vertices : 0;
+}
+
+int64_t qf_result_num_faces(const qf_result* result) {
+    return result ? result->result.num_faces : 0;
+}
+
+const double* qf_result_vertices(const qf_result* result) {
+    if (!result || result->result.vertices.empty()) return nullptr;
+    return result->result.vertices.data();
+}
+
+const int32_t* qf_result_faces(const qf_result* result) {
+    if (!result || result->result.faces.empty()) return nullptr;
+    return result->result.faces.data();
+}
+
+qf_status qf_result_copy_vertices(const qf_result* result, double* buffer, int64_t capacity) {
+    if (!result || (!buffer && capacity > 0)) {
+        return Fail(QF_ERROR_INVALID_ARGUMENT, "result and buffer must not be NULL");
+    }
+    const std::vector<double>& v = result->result.vertices;
+    if (capacity < (int64_t)v.size()) return Fail(QF_ERROR_BUFFER_TOO_SMALL, "vertex buffer too small");
+    if (!v.empty()) std::memcpy(buffer, v.data(), sizeof(double) * v.size());
+    return QF_OK;
+}
+
+qf_status qf_result_copy_faces(const qf_result* result, int32_t* buffer, int64_t capacity) {
+    if (!result || (!buffer && capacity > 0)) {
+        return Fail(QF_ERROR_INVALID_ARGUMENT, "result and buffer must not be NULL");
+    }
+    const std::vector<int>& f = result->result.faces;
+    if (capacity < (int64_t)f.size()) return Fail(QF_ERROR_BUFFER_TOO_SMALL, "face buffer too small");
+    if (!f.empty()) std::memcpy(buffer, f.data(), sizeof(int32_t) * f.size());
+    return QF_OK;
+}
+
+const uint8_t* qf_result_encoded(const qf_result* result, int64_t* size) {
+    const bool has = result && !result->result.encoded.empty();
+    if (size) *size = has ? (int64_t)result->result.encoded.size() : 0;
+    return has ? result->result.encoded.data() : nullptr;
+}
+
+uint32_t qf_result_degradations(const qf_result* result) {
+    return result ? result->result.degradations : 0;
+}
+
+int32_t qf_result_num_singularities(const qf_result* result) {
+    return result ? result->result.num_singularities : -1;
+}
+
+int64_t qf_result_num_stages(const qf_result* result) {
+    return result ? (int64_t)result->result.stages.size() : 0;
+}
+
+const char* qf_result_stage_name(const qf_result* result, int64_t stage) {
+    if (!result || stage < 0 || stage >= (int64_t)result->result.stages.size()) return nullptr;
+    return result->result.stages[stage].name.c_str();
+}
+
+double qf_result_stage_seconds(const qf_result* result, int64_t stage) {
+    if (!result || stage < 0 || stage >= (int64_t)result->result.stages.size()) return 0.0;
+    return result->result.stages[stage].seconds;
+}
+
+qf_status qf_configure_thread_pool(int32_t num_threads, int32_t pin_threads) {
+    if (num_threads < 0) return Fail(QF_ERROR_INVALID_ARGUMENT, "num_threads must not be negative");
+    return Guard([&]() {
+        configure_thread_pool(num_threads, pin_threads != 0);
+        return QF_OK;
+    });
+}
+
+void qf_shutdown(void) {
+    shutdown_thread_pool();
+}
+
+} // extern "C"
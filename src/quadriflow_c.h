@@ -0,0 +1,153 @@
+/* Stable C ABI for the QuadriFlow pipeline (libquadriflow_c).
+ *
+ * For embedding without Python or C++: Rust, Go, C#, ... bind this header
+ * directly. Results are opaque handles owning library-allocated buffers,
+ * which are read in place (borrowed pointers, valid until the handle is
+ * freed) or copied into caller-provided buffers. Every fallible call
+ * returns a qf_status; the message of the last failure on the calling
+ * thread is available from qf_last_error().
+ *
+ * ABI rules: handles are opaque; qf_options carries its own size so that
+ * fields can be appended without breaking callers built against older
+ * headers (the library never reads or writes past a caller's struct_size);
+ * enum values and signatures never change. Compare qf_api_version() with
+ * QF_API_VERSION to detect a mismatched library.
+ */
+
+#ifndef PYQUADRIFLOW_QUADRIFLOW_C_H
+#define PYQUADRIFLOW_QUADRIFLOW_C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(QF_BUILDING_LIBRARY)
+#    define QF_API __declspec(dllexport)
+#  else
+#    define QF_API __declspec(dllimport)
+#  endif
+#else
+#  define QF_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define QF_API_VERSION 2
+
+typedef enum qf_status {
+    QF_OK = 0,
+    QF_ERROR_INVALID_ARGUMENT = 1,  /* null pointer, bad count or option */
+    QF_ERROR_OUT_OF_MEMORY = 2,
+    QF_ERROR_CANCELLED = 3,         /* the cancel callback returned nonzero */
+    QF_ERROR_BUFFER_TOO_SMALL = 4,  /* caller buffer below the needed count */
+    QF_ERROR_FAILED = 5             /* remeshing failed; see qf_last_error() */
+} qf_status;
+
+/* Bits of qf_result_degradations(): what was dropped to meet
+ * time_budget_ms. */
+#define QF_DEGRADE_SKIP_MINIMUM_COST_FLOW 0x1u  /* minimum_cost_flow refinement dropped */
+#define QF_DEGRADE_SKIP_AGGRESSIVE_SAT    0x2u  /* aggressive_sat refinement dropped */
+#define QF_DEGRADE_FEWER_ITERATIONS       0x4u  /* fewer smoothing sweeps per level */
+#define QF_DEGRADE_COARSE_LEVELS_ONLY     0x8u  /* finest levels only prolongated */
+
+/* Called on the calling thread as each stage starts, with the stage name
+ * and the nominal fraction of the call done, and with ("done", 1.0) on
+ * success. `stage` is valid during the call only. */
+typedef void (*qf_progress_fn)(const char* stage, double fraction, void* user_data);
+
+/* Polled at every stage and between hierarchy levels of the smoothing
+ * sweeps; a nonzero return stops the call with QF_ERROR_CANCELLED. */
+typedef int (*qf_cancel_fn)(void* user_data);
+
+typedef struct qf_options {
+    uint32_t struct_size;         /* caller's sizeof(qf_options), set by qf_options_init */
+    int32_t target_faces;
+    int32_t seed;
+    int32_t preserve_sharp;       /* booleans: 0 or 1 */
+    int32_t preserve_boundary;
+    int32_t adaptive_scale;
+    int32_t aggressive_sat;
+    int32_t minimum_cost_flow;
+    int32_t reorder_output;
+    int32_t encode_position_bits; /* 0, or 1-32: quantized output only */
+    double time_budget_ms;        /* soft deadline, 0 disables */
+    qf_progress_fn progress;      /* optional */
+    qf_cancel_fn cancel;          /* optional */
+    void* user_data;              /* passed to progress and cancel */
+    int32_t domain_decomposition; /* boolean: parallel block sweeps */
+    int32_t balanced_coloring;    /* boolean: parallel balanced recolouring */
+    int32_t chaotic_relaxation;   /* boolean: barrier-free, non-deterministic sweeps */
+} qf_options;
+
+/* Opaque remeshing result. */
+typedef struct qf_result qf_result;
+
+QF_API uint32_t qf_api_version(void);
+
+/* Human-readable name of a status code (static storage). */
+QF_API const char* qf_status_string(qf_status status);
+
+/* Message of the last failed call on this thread ("" if none). Valid until
+ * the next call on this thread. */
+QF_API const char* qf_last_error(void);
+
+/* Fill the first `struct_size` bytes of `options` (the caller's
+ * sizeof(qf_options)) with the defaults: all flags off, seed 0. Fields the
+ * library does not know stay untouched, as do bytes past struct_size.
+ * Bindings that cannot use the macro below pass their struct size here. */
+QF_API void qf_options_init_sized(qf_options* options, size_t struct_size);
+
+/* Same, sized by this header. The exported function of this name (API
+ * version 1, before the size was passed) fills the version 1 fields only. */
+QF_API void (qf_options_init)(qf_options* options);
+#define qf_options_init(options) qf_options_init_sized((options), sizeof(qf_options))
+
+/* Remesh a triangle mesh: `vertices` is num_vertices x 3 doubles, `faces`
+ * num_faces x 3 vertex indices. On QF_OK *result owns the output; free it
+ * with qf_result_free(). On failure *result is set to NULL. */
+QF_API qf_status qf_remesh(
+    const double* vertices, int64_t num_vertices,
+    const int32_t* faces, int64_t num_faces,
+    const qf_options* options,
+    qf_result** result);
+
+QF_API void qf_result_free(qf_result* result);
+
+QF_API int64_t qf_result_num_vertices(const qf_result* result);
+QF_API int64_t qf_result_num_faces(const qf_result* result);  /* quads */
+
+/* Borrowed views of the output: num_vertices x 3 doubles and num_faces x 4
+ * indices. NULL for results with encode_position_bits set. */
+QF_API const double* qf_result_vertices(const qf_result* result);
+QF_API const int32_t* qf_result_faces(const qf_result* result);
+
+/* Copy the output into caller buffers of `capacity` elements (doubles,
+ * resp. indices); QF_ERROR_BUFFER_TOO_SMALL if below 3 * num_vertices,
+ * resp. 4 * num_faces. */
+QF_API qf_status qf_result_copy_vertices(const qf_result* result, double* buffer, int64_t capacity);
+QF_API qf_status qf_result_copy_faces(const qf_result* result, int32_t* buffer, int64_t capacity);
+
+/* Quantized encoding (encode_position_bits set), else NULL and size 0. */
+QF_API const uint8_t* qf_result_encoded(const qf_result* result, int64_t* size);
+
+QF_API uint32_t qf_result_degradations(const qf_result* result);  /* QF_DEGRADE_* bits */
+QF_API int32_t qf_result_num_singularities(const qf_result* result);
+
+/* Per-stage wall times, in order. Names are valid until qf_result_free. */
+QF_API int64_t qf_result_num_stages(const qf_result* result);
+QF_API const char* qf_result_stage_name(const qf_result* result, int64_t stage);
+QF_API double qf_result_stage_seconds(const qf_result* result, int64_t stage);
+
+/* Size the library's worker pool (0: one per CPU in the process's affinity
+ * mask) and optionally pin its workers; qf_shutdown() joins them (the next
+ * parallel call restarts). */
+QF_API qf_status qf_configure_thread_pool(int32_t num_threads, int32_t pin_threads);
+QF_API void qf_shutdown(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PYQUADRIFLOW_QUADRIFLOW_C_H */
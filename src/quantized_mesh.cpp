@@ -0,0 +1,188 @@
+// Quantized binary format for remeshing results (see pipeline.h).
+// Pure C++ — no QuadriFlow headers. Byte order is written explicitly, so
+// files are portable between hosts.
+
+#include "pipeline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+const unsigned char kMagic[4] = {'Q', 'F', 'Q', 'M'};
+const uint16_t kVersion = 1;
+const size_t kHeaderSize = 80;
+const int kCornersPerFace = 4;
+
+void PutLE(unsigned char* out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) out[i] = (unsigned char)(value >> (8 * i));
+}
+
+uint64_t GetLE(const unsigned char* in, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) value |= (uint64_t)in[i] << (8 * i);
+    return value;
+}
+
+void PutDouble(unsigned char* out, double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    PutLE(out, bits, 8);
+}
+
+double GetDouble(const unsigned char* in) {
+    const uint64_t bits = GetLE(in, 8);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+size_t PaddedPositionBytes(uint64_t num_vertices, int position_bits) {
+    const size_t width = position_bits <= 16 ? 2 : 4;
+    return (num_vertices * 3 * width + 7) & ~(size_t)7;
+}
+
+[[noreturn]] void Corrupt() {
+    throw std::runtime_error("Corrupt quantized mesh");
+}
+
+} // namespace
+
+std::vector<unsigned char> encode_quadriflow_result(
+    const QuadriFlowResult& result,
+    int position_bits,
+    const double* box_min,
+    const double* box_max
+) {
+    if (position_bits < 1 || position_bits > 32) {
+        throw std::runtime_error("position_bits must be in [1, 32]");
+    }
+    const size_t num_vertices = result.vertices.size() / 3;
+    const size_t num_faces = result.faces.size() / kCornersPerFace;
+    const double* v = result.vertices.data();
+
+    double lo[3], hi[3];
+    for (int d = 0; d < 3; ++d) {
+        if (box_min && box_max) {
+            lo[d] = box_min[d];
+            hi[d] = box_max[d];
+            continue;
+        }
+        lo[d] = std::numeric_limits<double>::max();
+        hi[d] = std::numeric_limits<double>::lowest();
+        for (size_t i = 0; i < num_vertices; ++i) {
+            lo[d] = std::min(lo[d], v[i * 3 + d]);
+            hi[d] = std::max(hi[d], v[i * 3 + d]);
+        }
+        if (num_vertices == 0) lo[d] = hi[d] = 0;
+    }
+
+    const double levels = (double)((uint64_t(1) << position_bits) - 1);
+    double step[3];
+    for (int d = 0; d < 3; ++d) step[d] = hi[d] > lo[d] ? (hi[d] - lo[d]) / levels : 0.0;
+
+    // Header and positions
+    const size_t position_bytes = PaddedPositionBytes(num_vertices, position_bits);
+    std::vector<unsigned char> out(kHeaderSize + position_bytes, 0);
+    std::memcpy(out.data(), kMagic, 4);
+    PutLE(&out[4], kVersion, 2);
+    out[6] = (unsigned char)position_bits;
+    out[7] = (unsigned char)kCornersPerFace;
+    PutLE(&out[8], num_vertices, 8);
+    PutLE(&out[16], num_faces, 8);
+    for (int d = 0; d < 3; ++d) {
+        PutDouble(&out[24 + 8 * d], lo[d]);
+        PutDouble(&out[48 + 8 * d], step[d]);
+    }
+
+    const int width = position_bits <= 16 ? 2 : 4;
+    unsigned char* q = &out[kHeaderSize];
+    for (size_t i = 0; i < num_vertices * 3; ++i) {
+        const int d = (int)(i % 3);
+        double level = step[d] > 0 ? std::round((v[i] - lo[d]) / step[d]) : 0.0;
+        level = std::min(std::max(level, 0.0), levels);
+        PutLE(q + i * width, (uint64_t)level, width);
+    }
+
+    // Indices: zigzag varints of the running difference
+    int64_t previous = 0;
+    for (int index : result.faces) {
+        const int64_t delta = (int64_t)index - previous;
+        previous = index;
+        uint64_t zigzag = ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+        while (zigzag >= 0x80) {
+            out.push_back((unsigned char)(zigzag | 0x80));
+            zigzag >>= 7;
+        }
+        out.push_back((unsigned char)zigzag);
+    }
+    PutLE(&out[72], out.size() - kHeaderSize - position_bytes, 8);
+    return out;
+}
+
+QuadriFlowResult decode_quadriflow_result(const unsigned char* data, size_t size) {
+    if (size < kHeaderSize || std::memcmp(data, kMagic, 4) != 0) {
+        throw std::runtime_error("Not a quantized QuadriFlow mesh");
+    }
+    if (GetLE(&data[4], 2) != kVersion) {
+        throw std::runtime_error("Unsupported quantized mesh version");
+    }
+    const int position_bits = data[6];
+    if (position_bits < 1 || position_bits > 32 || data[7] != kCornersPerFace) Corrupt();
+
+    const uint64_t num_vertices = GetLE(&data[8], 8);
+    const uint64_t num_faces = GetLE(&data[16], 8);
+    const uint64_t index_bytes = GetLE(&data[72], 8);
+    // Indices are int32; every corner takes at least one byte of the stream
+    if (num_vertices > (uint64_t)std::numeric_limits<int>::max() ||
+        num_faces > index_bytes / kCornersPerFace) {
+        Corrupt();
+    }
+    const size_t position_bytes = PaddedPositionBytes(num_vertices, position_bits);
+    if (size - kHeaderSize < position_bytes ||
+        size - kHeaderSize - position_bytes < index_bytes) {
+        Corrupt();
+    }
+
+    double origin[3], step[3];
+    for (int d = 0; d < 3; ++d) {
+        origin[d] = GetDouble(&data[24 + 8 * d]);
+        step[d] = GetDouble(&data[48 + 8 * d]);
+    }
+
+    QuadriFlowResult result;
+    result.num_vertices = (int64_t)num_vertices;
+    result.num_faces = (int64_t)num_faces;
+
+    const int width = position_bits <= 16 ? 2 : 4;
+    const unsigned char* q = data + kHeaderSize;
+    result.vertices.resize(num_vertices * 3);
+    for (size_t i = 0; i < num_vertices * 3; ++i) {
+        const int d = (int)(i % 3);
+        result.vertices[i] = origin[d] + (double)GetLE(q + i * width, width) * step[d];
+    }
+
+    const unsigned char* in = q + position_bytes;
+    const unsigned char* end = in + index_bytes;
+    result.faces.resize(num_faces * kCornersPerFace);
+    int64_t previous = 0;
+    for (int& index : result.faces) {
+        uint64_t zigzag = 0;
+        for (int shift = 0;; shift += 7) {
+            if (in == end || shift > 63) Corrupt();
+            const unsigned char byte = *in++;
+            zigzag |= (uint64_t)(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) break;
+        }
+        const int64_t delta = (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+        previous += delta;
+        if (previous < 0 || previous >= (int64_t)num_vertices) Corrupt();
+        index = (int)previous;
+    }
+    return result;
+}
@@ -0,0 +1,158 @@
+// Resource estimation for run_quadriflow().
+// Pure C++ — no QuadriFlow headers; only cheap O(F) mesh analysis plus a
+// linear cost model (see QuadriFlowCostModel in pipeline.h).
+
+#include "pipeline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+struct DisjointSet {
+    std::vector<int> parent;
+
+    explicit DisjointSet(size_t n) : parent(n) {
+        std::iota(parent.begin(), parent.end(), 0);
+    }
+
+    int find(int i) {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    }
+
+    void unite(int a, int b) {
+        a = find(a);
+        b = find(b);
+        if (a != b) parent[std::max(a, b)] = std::min(a, b);
+    }
+};
+
+inline double Distance(const double* vertices, int a, int b) {
+    const double* p = vertices + (size_t)a * 3;
+    const double* q = vertices + (size_t)b * 3;
+    const double dx = p[0] - q[0], dy = p[1] - q[1], dz = p[2] - q[2];
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+inline double TriangleArea(const double* vertices, int a, int b, int c) {
+    const double* p0 = vertices + (size_t)a * 3;
+    const double* p1 = vertices + (size_t)b * 3;
+    const double* p2 = vertices + (size_t)c * 3;
+    const double e0[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+    const double e1[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+    const double cx = e0[1] * e1[2] - e0[2] * e1[1];
+    const double cy = e0[2] * e1[0] - e0[0] * e1[2];
+    const double cz = e0[0] * e1[1] - e0[1] * e1[0];
+    return 0.5 * std::sqrt(cx * cx + cy * cy + cz * cz);
+}
+
+} // namespace
+
+QuadriFlowResourceEstimate estimate_resources(
+    const double* vertices, int64_t num_vertices,
+    const int* faces, int64_t num_faces,
+    const QuadriFlowOptions& options,
+    const QuadriFlowCostModel& model
+) {
+    if (num_vertices <= 0 || num_faces <= 0) {
+        throw std::runtime_error("Input mesh is empty");
+    }
+    if (options.target_faces <= 0) {
+        throw std::runtime_error("target_faces must be positive");
+    }
+
+    QuadriFlowResourceEstimate est = {};
+
+    // Topology: connected components and boundary edges (used by one face).
+    // int32 face indices reach at most the first 2^31 vertices.
+    const int64_t indexable = std::min(num_vertices, kQuadriFlowMaxSolverVertices + 1);
+    DisjointSet components((size_t)indexable);
+    std::vector<char> referenced((size_t)indexable, 0);
+    std::unordered_map<uint64_t, int> edge_use;
+    edge_use.reserve(static_cast<size_t>(num_faces) * 2);
+
+    double total_edge_length = 0.0;
+    double max_edge_length = 0.0;
+
+    for (int64_t f = 0; f < num_faces; ++f) {
+        const int* tri = faces + f * 3;
+        for (int k = 0; k < 3; ++k) {
+            if (tri[k] < 0 || tri[k] >= num_vertices) {
+                throw std::runtime_error("Face index out of range");
+            }
+            referenced[tri[k]] = 1;
+        }
+        est.surface_area += TriangleArea(vertices, tri[0], tri[1], tri[2]);
+        for (int k = 0; k < 3; ++k) {
+            const int a = tri[k], b = tri[(k + 1) % 3];
+            components.unite(a, b);
+            const uint64_t key = (static_cast<uint64_t>(std::min(a, b)) << 32) |
+                                 static_cast<uint32_t>(std::max(a, b));
+            edge_use[key] += 1;
+            const double len = Distance(vertices, a, b);
+            total_edge_length += len;
+            max_edge_length = std::max(max_edge_length, len);
+        }
+    }
+
+    for (int64_t v = 0; v < indexable; ++v) {
+        if (referenced[v] && components.find((int)v) == v) ++est.num_components;
+    }
+    for (const auto& kv : edge_use) {
+        if (kv.second != 1) continue;
+        const int a = static_cast<int>(kv.first >> 32);
+        const int b = static_cast<int>(kv.first & 0xffffffffu);
+        ++est.num_boundary_edges;
+        est.boundary_length += Distance(vertices, a, b);
+    }
+
+    est.target_ratio = static_cast<double>(options.target_faces) / (double)num_faces;
+
+    // Parametrizer::Initialize splits edges longer than
+    // min(scale / 2, 2 * average edge length), scale = sqrt(area / target) / 2.
+    // Every such triangle turns into roughly ceil(L / target_len)^2 faces.
+    const double average_edge_length = total_edge_length / (3.0 * num_faces);
+    const double scale = std::sqrt(est.surface_area / options.target_faces) / 2;
+    const double target_len = std::min(scale / 2, average_edge_length * 2);
+    est.working_faces = (double)num_faces;
+    if (target_len > 0 && max_edge_length > target_len) {
+        est.working_faces = 0;
+        for (int64_t f = 0; f < num_faces; ++f) {
+            const int* tri = faces + f * 3;
+            double longest = std::max({Distance(vertices, tri[0], tri[1]),
+                                       Distance(vertices, tri[1], tri[2]),
+                                       Distance(vertices, tri[2], tri[0])});
+            double splits = std::max(1.0, std::ceil(longest / target_len));
+            est.working_faces += splits * splits;
+        }
+    }
+    // Euler: a closed triangle mesh has about half as many vertices as faces
+    const double working_vertices = est.working_faces / 2 + est.num_boundary_edges;
+
+    est.peak_memory_bytes = model.base_bytes
+        + model.bytes_per_input_face * (double)num_faces
+        + model.bytes_per_working_vertex * working_vertices;
+
+    double field_seconds = model.seconds_per_working_face * est.working_faces;
+    if (options.adaptive_scale) field_seconds *= model.adaptive_scale_factor;
+
+    double extract_seconds = model.seconds_per_output_face * options.target_faces;
+    if (options.preserve_sharp)    extract_seconds *= model.preserve_sharp_factor;
+    if (options.aggressive_sat)    extract_seconds *= model.aggressive_sat_factor;
+    if (options.minimum_cost_flow) extract_seconds *= model.minimum_cost_flow_factor;
+
+    est.runtime_seconds = model.base_seconds + field_seconds + extract_seconds
+        + model.seconds_per_boundary_edge * est.num_boundary_edges
+        + model.seconds_per_component * est.num_components;
+
+    return est;
+}
@@ -0,0 +1,249 @@
+// Region-of-interest remeshing: remesh the faces selected by a mask with
+// their border pinned (preserve_boundary), then zip the quad patch back to
+// the untouched triangles with a strip of triangles.
+// Pure C++ — no QuadriFlow headers; runs the regular pipeline on the ROI.
+
+#include "pipeline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+inline uint64_t DirectedKey(int a, int b) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(a)) << 32) | static_cast<uint32_t>(b);
+}
+
+inline double Distance2(const double* p, const double* q) {
+    const double dx = p[0] - q[0], dy = p[1] - q[1], dz = p[2] - q[2];
+    return dx * dx + dy * dy + dz * dz;
+}
+
+// Closed boundary loops of a polygon soup with `arity` corners per face:
+// directed edges whose reverse is not used by any face, chained head to tail.
+// Loops that do not close (non-manifold borders) are dropped.
+std::vector<std::vector<int>> BoundaryLoops(const int* faces, size_t num_faces, int arity) {
+    std::unordered_set<uint64_t> directed;
+    directed.reserve(num_faces * arity);
+    for (size_t f = 0; f < num_faces; ++f) {
+        for (int k = 0; k < arity; ++k) {
+            const int a = faces[f * arity + k], b = faces[f * arity + (k + 1) % arity];
+            directed.insert(DirectedKey(a, b));
+        }
+    }
+
+    std::unordered_map<int, int> next;
+    for (size_t f = 0; f < num_faces; ++f) {
+        for (int k = 0; k < arity; ++k) {
+            const int a = faces[f * arity + k], b = faces[f * arity + (k + 1) % arity];
+            if (a != b && !directed.count(DirectedKey(b, a))) next.emplace(a, b);
+        }
+    }
+
+    std::vector<std::vector<int>> loops;
+    std::unordered_map<int, char> used;
+    for (const auto& kv : next) {
+        if (used.count(kv.first)) continue;
+        std::vector<int> loop;
+        int v = kv.first;
+        bool closed = false;
+        while (!used.count(v)) {
+            used[v] = 1;
+            loop.push_back(v);
+            auto it = next.find(v);
+            if (it == next.end()) break;
+            v = it->second;
+            if (v == kv.first) {
+                closed = true;
+                break;
+            }
+        }
+        if (closed && loop.size() >= 3) loops.push_back(std::move(loop));
+    }
+    return loops;
+}
+
+void LoopCentroid(const std::vector<int>& loop, const double* positions, double* c) {
+    c[0] = c[1] = c[2] = 0;
+    for (int v : loop) {
+        for (int d = 0; d < 3; ++d) c[d] += positions[(size_t)v * 3 + d];
+    }
+    for (int d = 0; d < 3; ++d) c[d] /= loop.size();
+}
+
+struct BandCorner {
+    int id;
+    bool on_roi;   // id is an original vertex (ROI border), else a quad vertex
+};
+
+// Triangulate the band between an outer loop `a` (ROI border, original
+// vertex ids) and an inner loop `b` (quad border, output ids). Both loops run
+// the same way around the patch, so the band is bounded by a and reversed b.
+void ZipLoops(
+    const std::vector<int>& a, const double* pa,
+    const std::vector<int>& b, const double* pb,
+    std::vector<BandCorner>& band
+) {
+    // Start b at the vertex closest to a[0]
+    size_t start = 0;
+    double best = std::numeric_limits<double>::max();
+    for (size_t j = 0; j < b.size(); ++j) {
+        const double d = Distance2(pa + (size_t)a[0] * 3, pb + (size_t)b[j] * 3);
+        if (d < best) {
+            best = d;
+            start = j;
+        }
+    }
+
+    size_t i = 0, j = 0;
+    while (i < a.size() || j < b.size()) {
+        const int ai = a[i % a.size()], ai1 = a[(i + 1) % a.size()];
+        const int bj = b[(start + j) % b.size()], bj1 = b[(start + j + 1) % b.size()];
+        bool advance_a;
+        if (i == a.size()) advance_a = false;
+        else if (j == b.size()) advance_a = true;
+        else advance_a = Distance2(pa + (size_t)ai1 * 3, pb + (size_t)bj * 3) <=
+                         Distance2(pa + (size_t)ai * 3, pb + (size_t)bj1 * 3);
+
+        if (advance_a) {
+            band.insert(band.end(), {{ai, true}, {ai1, true}, {bj, false}});
+            ++i;
+        } else {
+            band.insert(band.end(), {{ai, true}, {bj1, false}, {bj, false}});
+            ++j;
+        }
+    }
+}
+
+} // namespace
+
+QuadriFlowResult run_quadriflow_roi(
+    const double* vertices, int64_t num_vertices,
+    const int* faces, int64_t num_faces,
+    const unsigned char* face_mask,
+    const QuadriFlowOptions& options
+) {
+    if (num_vertices <= 0 || num_faces <= 0) {
+        throw std::runtime_error("Input mesh is empty");
+    }
+    if (options.encode_position_bits) {
+        // The quantized format holds quads only, not the stitching band
+        throw std::runtime_error("encode_position_bits is not supported for ROI remeshing");
+    }
+
+    // Untouched faces are copied into the output, so every index is checked
+    for (int64_t c = 0; c < num_faces * 3; ++c) {
+        if (faces[c] < 0 || faces[c] >= num_vertices) {
+            throw std::runtime_error("Face index out of range");
+        }
+    }
+
+    // 1. Extract the ROI submesh; the vertex map only grows with the ROI.
+    //    Local ids stay below 2^31: there are no more than distinct int32
+    //    face indices.
+    std::unordered_map<int64_t, int64_t> to_local;
+    std::vector<int64_t> to_global;
+    std::vector<int> sub_faces;
+    for (int64_t f = 0; f < num_faces; ++f) {
+        if (!face_mask[f]) continue;
+        for (int k = 0; k < 3; ++k) {
+            const int64_t v = faces[f * 3 + k];
+            auto it = to_local.emplace(v, (int64_t)to_global.size());
+            if (it.second) to_global.push_back(v);
+            sub_faces.push_back((int)it.first->second);
+        }
+    }
+    if (sub_faces.empty()) {
+        throw std::runtime_error("face_mask selects no faces");
+    }
+
+    std::vector<double> sub_vertices(to_global.size() * 3);
+    for (size_t i = 0; i < to_global.size(); ++i) {
+        for (int d = 0; d < 3; ++d) sub_vertices[i * 3 + d] = vertices[to_global[i] * 3 + d];
+    }
+
+    // 2. Remesh it with the ROI border as a boundary constraint
+    QuadriFlowOptions roi_options = options;
+    roi_options.preserve_boundary = true;
+    QuadriFlowResult result = run_quadriflow(
+        sub_vertices.data(), (int64_t)to_global.size(),
+        sub_faces.data(), (int64_t)(sub_faces.size() / 3), roi_options);
+
+    // 3. Pair every ROI border loop with the nearest quad border loop
+    std::vector<std::vector<int>> roi_loops =
+        BoundaryLoops(sub_faces.data(), sub_faces.size() / 3, 3);
+    std::vector<std::vector<int>> quad_loops =
+        BoundaryLoops(result.faces.data(), result.faces.size() / 4, 4);
+
+    std::vector<BandCorner> band;
+    std::vector<char> quad_loop_used(quad_loops.size(), 0);
+    for (const auto& roi_loop : roi_loops) {
+        double ca[3];
+        LoopCentroid(roi_loop, sub_vertices.data(), ca);
+        int match = -1;
+        double best = std::numeric_limits<double>::max();
+        for (size_t q = 0; q < quad_loops.size(); ++q) {
+            if (quad_loop_used[q]) continue;
+            double cb[3];
+            LoopCentroid(quad_loops[q], result.vertices.data(), cb);
+            const double d = Distance2(ca, cb);
+            if (d < best) {
+                best = d;
+                match = (int)q;
+            }
+        }
+        if (match < 0) continue;  // quad patch closed this hole; leave it open
+        quad_loop_used[match] = 1;
+        ZipLoops(roi_loop, sub_vertices.data(), quad_loops[match], result.vertices.data(), band);
+    }
+
+    // 4. Assemble: original vertices still in use, then the quad vertices.
+    //    Number the kept vertices in order of first use, check the total
+    //    against the int32 limit, then write the int32 output indices.
+    std::vector<int64_t> kept((size_t)num_vertices, -1);
+    int64_t num_kept = 0;
+    auto keep = [&](int64_t v) {
+        if (kept[v] == -1) kept[v] = num_kept++;
+    };
+    for (int64_t f = 0; f < num_faces; ++f) {
+        if (face_mask[f]) continue;
+        for (int k = 0; k < 3; ++k) keep(faces[f * 3 + k]);
+    }
+    for (const BandCorner& c : band) {
+        if (c.on_roi) keep(to_global[c.id]);
+    }
+    if (num_kept + result.num_vertices > kQuadriFlowMaxSolverVertices) {
+        throw std::runtime_error("ROI result has too many vertices for int32 face indices");
+    }
+
+    std::vector<int> triangles;
+    for (int64_t f = 0; f < num_faces; ++f) {
+        if (face_mask[f]) continue;
+        for (int k = 0; k < 3; ++k) triangles.push_back((int)kept[faces[f * 3 + k]]);
+    }
+    for (const BandCorner& c : band) {
+        triangles.push_back(c.on_roi ? (int)kept[to_global[c.id]] : c.id + (int)num_kept);
+    }
+
+    std::vector<double> out_vertices((size_t)(num_kept + result.num_vertices) * 3);
+    for (int64_t v = 0; v < num_vertices; ++v) {
+        if (kept[v] == -1) continue;
+        for (int d = 0; d < 3; ++d) out_vertices[kept[v] * 3 + d] = vertices[v * 3 + d];
+    }
+    std::copy(result.vertices.begin(), result.vertices.end(),
+              out_vertices.begin() + num_kept * 3);
+
+    for (int& v : result.faces) v += (int)num_kept;
+
+    result.vertices = std::move(out_vertices);
+    result.num_vertices = num_kept + result.num_vertices;
+    result.triangles = std::move(triangles);
+    result.num_triangles = (int64_t)(result.triangles.size() / 3);
+    return result;
+}
@@ -0,0 +1,363 @@
+// Persistent worker pool behind thread_pool.h, and the default executor
+// of pipeline.h on top of it.
+
+#include "thread_pool.h"
+
+#include "numa.h"
+#include "pipeline.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+namespace {
+
+thread_local bool t_pool_worker = false;
+thread_local int t_worker_node = 0;
+
+class Pool {
+public:
+    Pool(int num_threads, bool pin_threads) : nodes_(num_threads) {
+        // Deficit round-robin: each worker goes to the node furthest below
+        // its CPU share, so every prefix of workers is proportional too
+        const int num_nodes = NumaNodeCount();
+        std::vector<int> assigned(num_nodes, 0);
+        int total_cpus = 0;
+        for (int node = 0; node < num_nodes; ++node) total_cpus += NumaNodeCpuCount(node);
+        for (int w = 0; w < num_threads; ++w) {
+            int best = 0;
+            double best_deficit = -1e300;
+            for (int node = 0; node < num_nodes && total_cpus > 0; ++node) {
+                const double deficit =
+                    (double)NumaNodeCpuCount(node) * (w + 1) / total_cpus - assigned[node];
+                if (deficit > best_deficit) {
+                    best = node;
+                    best_deficit = deficit;
+                }
+            }
+            nodes_[w] = best;
+            const int cpu = pin_threads ? assigned[best] : -1;
+            ++assigned[best];
+            threads_.emplace_back([this, w, cpu]() { Work(w, cpu); });
+        }
+    }
+
+    ~Pool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& thread : threads_) thread.join();
+    }
+
+    int Size() const { return (int)threads_.size(); }
+    int Node(int worker) const { return nodes_[worker]; }
+
+    // False when another job is running; the caller then runs it inline.
+    bool TryRun(int num_workers, const std::function<void(int)>& job) {
+        std::unique_lock<std::mutex> run(run_mutex_, std::try_to_lock);
+        if (!run.owns_lock()) return false;
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        job_ = &job;
+        num_workers_ = num_workers;
+        remaining_ = num_workers;
+        error_ = nullptr;
+        ++generation_;
+        wake_.notify_all();
+        done_.wait(lock, [&]() { return remaining_ == 0; });
+        job_ = nullptr;
+        if (error_) std::rethrow_exception(error_);
+        return true;
+    }
+
+    void Submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        wake_.notify_one();
+    }
+
+private:
+    void Work(int worker, int cpu) {
+        t_pool_worker = true;
+        t_worker_node = nodes_[worker];
+        NumaBindThread(nodes_[worker], cpu);
+        uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            wake_.wait(lock, [&]() {
+                return stop_ || generation_ != seen || !tasks_.empty();
+            });
+            if (generation_ == seen) {
+                if (tasks_.empty()) return;  // stopped and drained
+                std::function<void()> task = std::move(tasks_.front());
+                tasks_.pop_front();
+                lock.unlock();
+                task();  // throwing out of the thread terminates
+                lock.lock();
+                continue;
+            }
+            seen = generation_;
+            if (worker >= num_workers_) continue;
+
+            const std::function<void(int)>& job = *job_;
+            lock.unlock();
+            std::exception_ptr error;
+            try {
+                job(worker);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            lock.lock();
+            if (error && !error_) error_ = error;
+            if (--remaining_ == 0) done_.notify_one();
+        }
+    }
+
+    std::vector<int> nodes_;
+    std::vector<std::thread> threads_;
+
+    std::mutex run_mutex_;   // one job at a time
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const std::function<void(int)>* job_ = nullptr;
+    int num_workers_ = 0;
+    int remaining_ = 0;
+    uint64_t generation_ = 0;
+    bool stop_ = false;
+    std::exception_ptr error_;
+    std::deque<std::function<void()>> tasks_;
+};
+
+std::mutex g_pool_mutex;
+std::shared_ptr<Pool> g_pool;
+int g_num_threads = 0;
+bool g_pin_threads = false;
+
+#ifndef _WIN32
+void PrepareFork() {
+    g_pool_mutex.lock();
+}
+
+void ParentAfterFork() {
+    g_pool_mutex.unlock();
+}
+
+void ChildAfterFork() {
+    // The workers and whatever state they held their locks in stayed in
+    // the parent: leak the copy rather than destroy (join) it
+    new std::shared_ptr<Pool>(std::move(g_pool));
+    g_pool_mutex.unlock();
+}
+#endif
+
+std::shared_ptr<Pool> GetPool() {
+    std::lock_guard<std::mutex> lock(g_pool_mutex);
+    if (!g_pool) {
+#ifndef _WIN32
+        static std::once_flag registered;
+        std::call_once(registered, []() {
+            pthread_atfork(PrepareFork, ParentAfterFork, ChildAfterFork);
+        });
+#endif
+        g_pool = std::make_shared<Pool>(g_num_threads > 0 ? g_num_threads : NumaCpuCount(),
+                                        g_pin_threads);
+    }
+    return g_pool;
+}
+
+} // namespace
+
+int ThreadPoolSize() {
+    return t_pool_worker ? 1 : GetPool()->Size();
+}
+
+int ThreadPoolWorkerNode(int worker) {
+    return t_pool_worker ? t_worker_node : GetPool()->Node(worker);
+}
+
+int ThreadPoolCurrentNode() {
+    return t_pool_worker ? t_worker_node : 0;
+}
+
+void ThreadPoolRun(int num_workers, const std::function<void(int)>& job) {
+    if (t_pool_worker) {
+        for (int w = 0; w < std::min(num_workers, 1); ++w) job(w);
+        return;
+    }
+    const std::shared_ptr<Pool> pool = GetPool();
+    num_workers = std::min(num_workers, pool->Size());
+    if (num_workers <= 0 || pool->TryRun(num_workers, job)) return;
+    for (int w = 0; w < num_workers; ++w) job(w);
+}
+
+void ThreadPoolParallelForHome(int n, const std::function<int(int)>& home,
+                               const std::function<void(int)>& body) {
+    if (n <= 0) return;
+    const int num_nodes = NumaNodeCount();
+    std::vector<std::vector<int>> owned(num_nodes);
+    for (int i = 0; i < n; ++i) {
+        owned[std::min(std::max(home(i), 0), num_nodes - 1)].push_back(i);
+    }
+    std::unique_ptr<std::atomic<size_t>[]> next(new std::atomic<size_t>[num_nodes]);
+    for (int node = 0; node < num_nodes; ++node) next[node] = 0;
+
+    std::exception_ptr error;
+    std::mutex mutex;
+    ThreadPoolRun(std::min(n, ThreadPoolSize()), [&](int) {
+        const int own = ThreadPoolCurrentNode();
+        for (int k = 0; k < num_nodes; ++k) {
+            const int node = (own + k) % num_nodes;
+            const std::vector<int>& items = owned[node];
+            for (size_t j = next[node]++; j < items.size(); j = next[node]++) {
+                try {
+                    body(items[j]);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error) error = std::current_exception();
+                }
+            }
+        }
+    });
+    if (error) std::rethrow_exception(error);
+}
+
+void ThreadPoolSubmit(std::function<void()> task) {
+    GetPool()->Submit(std::move(task));
+}
+
+void configure_thread_pool(int num_threads, bool pin_threads) {
+    shutdown_thread_pool();
+    std::lock_guard<std::mutex> lock(g_pool_mutex);
+    g_num_threads = std::max(num_threads, 0);
+    g_pin_threads = pin_threads;
+}
+
+void shutdown_thread_pool() {
+    std::shared_ptr<Pool> pool;
+    {
+        std::lock_guard<std::mutex> lock(g_pool_mutex);
+        pool.swap(g_pool);
+    }
+    // Calls still holding the pool keep it alive; the last one joins it
+}
+
+// ---------------------------------------------------------------------------
+// Executors
+// ---------------------------------------------------------------------------
+
+void QuadriFlowExecutor::parallel_for(int n, const std::function<void(int)>& body) {
+    if (n <= 0) return;
+
+    // Shared with the helpers, which may start after this call returned:
+    // they touch `body` only after claiming an index, and the caller waits
+    // for every claimed index to finish
+    struct State {
+        std::atomic<int> next{0};
+        int n = 0;
+        int finished = 0;
+        const std::function<void(int)>* body = nullptr;
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+    auto state = std::make_shared<State>();
+    state->n = n;
+    state->body = &body;
+
+    auto work = [](State& st) {
+        int count = 0;
+        for (int i = st.next++; i < st.n; i = st.next++, ++count) {
+            try {
+                (*st.body)(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(st.mutex);
+                if (!st.error) st.error = std::current_exception();
+            }
+        }
+        if (count == 0) return;
+        std::lock_guard<std::mutex> lock(st.mutex);
+        st.finished += count;
+        if (st.finished == st.n) st.done.notify_all();
+    };
+
+    const int helpers = std::min(n, concurrency()) - 1;
+    for (int h = 0; h < helpers; ++h) {
+        submit([state, work]() { work(*state); });
+    }
+    work(*state);
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done.wait(lock, [&]() { return state->finished == n; });
+    if (state->error) std::rethrow_exception(state->error);
+}
+
+namespace {
+
+class ThreadPoolExecutor : public QuadriFlowExecutor {
+public:
+    int concurrency() override { return ThreadPoolSize(); }
+
+    void submit(std::function<void()> task) override {
+        ThreadPoolSubmit(std::move(task));
+    }
+
+    // One pool job, each worker pulling indices, instead of a task each;
+    // the caller waits in ThreadPoolRun rather than taking indices itself
+    void parallel_for(int n, const std::function<void(int)>& body) override {
+        std::atomic<int> next(0);
+        std::exception_ptr error;
+        std::mutex mutex;
+        ThreadPoolRun(std::min(n, ThreadPoolSize()), [&](int) {
+            for (int i = next++; i < n; i = next++) {
+                try {
+                    body(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error) error = std::current_exception();
+                }
+            }
+        });
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+std::mutex g_executor_mutex;
+std::shared_ptr<QuadriFlowExecutor> g_executor;
+
+} // namespace
+
+std::shared_ptr<QuadriFlowExecutor> default_executor() {
+    static const std::shared_ptr<QuadriFlowExecutor> executor =
+        std::make_shared<ThreadPoolExecutor>();
+    return executor;
+}
+
+void set_executor(std::shared_ptr<QuadriFlowExecutor> executor) {
+    std::lock_guard<std::mutex> lock(g_executor_mutex);
+    g_executor = std::move(executor);
+}
+
+std::shared_ptr<QuadriFlowExecutor> get_executor() {
+    {
+        std::lock_guard<std::mutex> lock(g_executor_mutex);
+        if (g_executor) return g_executor;
+    }
+    return default_executor();
+}
@@ -0,0 +1,53 @@
+// Process-wide pool of warm worker threads.
+// Pure C++ — no QuadriFlow headers.
+//
+// Created on first use and reused by every parallel section of every call,
+// so a stream of small meshes does not pay thread creation and teardown per
+// call. Workers are spread over the NUMA nodes in proportion to their CPUs
+// (any prefix of workers is, too) and optionally pinned to single CPUs.
+//
+// Fork safety: a pthread_atfork handler holds the pool lock across fork(),
+// and the child drops its copy of the pool without touching it (its worker
+// threads do not exist there). The first parallel call in the child starts
+// a fresh pool; the parent's pool is unaffected.
+
+#ifndef PYQUADRIFLOW_THREAD_POOL_H
+#define PYQUADRIFLOW_THREAD_POOL_H
+
+#include <functional>
+
+// Worker threads of the pool (creating it if needed). On a pool worker the
+// pool is busy with the enclosing job, so nested parallel sections see 1.
+int ThreadPoolSize();
+
+// NUMA node (numa.h index) of pool worker `worker`.
+int ThreadPoolWorkerNode(int worker);
+
+// NUMA node of the calling thread if it is a pool worker, otherwise 0.
+int ThreadPoolCurrentNode();
+
+// Run job(w) for every w in [0, num_workers) concurrently, job(w) on pool
+// worker w, and wait; num_workers is capped at ThreadPoolSize(). The
+// calling thread only waits, also for workers still busy with a
+// ThreadPoolSubmit task. The first exception a job throws is rethrown here.
+// While another thread is running a job on the pool, the jobs run one after
+// another on the calling thread instead, so jobs must not wait for each
+// other.
+void ThreadPoolRun(int num_workers, const std::function<void(int)>& job);
+
+// Call body(i) for every i in [0, n) on the pool and wait, where index i
+// belongs to NUMA node home(i): each worker claims its own node's indices
+// first, in order, and only then helps the other nodes. Work whose data
+// was placed by node (NumaPartitionPages) thus mostly runs next to it. The
+// first exception a body throws is rethrown once all have finished.
+void ThreadPoolParallelForHome(int n, const std::function<int(int)>& home,
+                               const std::function<void(int)>& body);
+
+// Queue `task` for the next idle worker and return. An idle worker starts a
+// ThreadPoolRun job before queued tasks, but a worker already running a task
+// joins the job only when the task returns, so long tasks delay jobs. Queued
+// tasks still run before a shut down pool's workers exit. A task that throws
+// terminates the process.
+void ThreadPoolSubmit(std::function<void()> task);
+
+#endif // PYQUADRIFLOW_THREAD_POOL_H
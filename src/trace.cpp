@@ -0,0 +1,146 @@
+// Per-thread trace rings and Chrome trace JSON export.
+
+#include "trace.h"
+
+#include "pipeline.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+std::atomic<bool> g_tracing_enabled{false};
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    int index;
+    int64_t start_ns;
+    int64_t duration_ns;
+};
+
+// Single-producer ring: only the owning thread writes events and `head`;
+// export reads up to `head` and advances `tail`. When full, the oldest
+// events are overwritten.
+struct TraceRing {
+    static const uint64_t kCapacity = 1u << 14;
+
+    int tid = 0;
+    std::unique_ptr<TraceEvent[]> events{new TraceEvent[kCapacity]};
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> tail{0};
+    std::atomic<bool> in_use{true};
+};
+
+struct TraceRegistry {
+    std::mutex mutex;  // guards `rings`; taken once per thread, not per event
+    std::vector<std::unique_ptr<TraceRing>> rings;
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+};
+
+TraceRegistry& Registry() {
+    static TraceRegistry* registry = new TraceRegistry();  // outlives exiting threads
+    return *registry;
+}
+
+// Pool workers keep their ring for the life of the pool. Other threads
+// (a host executor's, or ones the host starts and ends) hand their ring
+// back on exit for the next new thread to reuse, so the number of rings
+// stays at the peak thread count.
+struct ThreadRing {
+    TraceRing* ring = nullptr;
+
+    TraceRing& Get() {
+        if (!ring) {
+            TraceRegistry& registry = Registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            for (auto& r : registry.rings) {
+                bool idle = false;
+                if (r->in_use.compare_exchange_strong(idle, true)) {
+                    ring = r.get();
+                    break;
+                }
+            }
+            if (!ring) {
+                registry.rings.emplace_back(new TraceRing());
+                ring = registry.rings.back().get();
+                ring->tid = (int)registry.rings.size();
+            }
+        }
+        return *ring;
+    }
+
+    ~ThreadRing() {
+        if (ring) ring->in_use.store(false, std::memory_order_release);
+    }
+};
+
+thread_local ThreadRing t_ring;
+
+void AppendJsonString(std::string& out, const char* s) {
+    out += '"';
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') out += '\\';
+        out += *s;
+    }
+    out += '"';
+}
+
+} // namespace
+
+int64_t TraceNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - Registry().epoch).count();
+}
+
+void TraceRecord(const char* name, int index, int64_t start_ns) {
+    TraceRing& ring = t_ring.Get();
+    const uint64_t head = ring.head.load(std::memory_order_relaxed);
+    ring.events[head % TraceRing::kCapacity] = {name, index, start_ns, TraceNow() - start_ns};
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+void set_tracing_enabled(bool enabled) {
+    g_tracing_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool tracing_enabled() {
+    return TracingEnabled();
+}
+
+std::string export_chrome_trace(bool clear) {
+    TraceRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    char buffer[160];
+    for (auto& ring : registry.rings) {
+        const uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        if (head - tail > TraceRing::kCapacity) tail = head - TraceRing::kCapacity;
+
+        for (uint64_t i = tail; i < head; ++i) {
+            const TraceEvent& e = ring->events[i % TraceRing::kCapacity];
+            out += first ? "{\"name\":" : ",{\"name\":";
+            first = false;
+            AppendJsonString(out, e.name);
+            std::snprintf(buffer, sizeof(buffer),
+                ",\"cat\":\"quadriflow\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+                "\"ts\":%.3f,\"dur\":%.3f",
+                ring->tid, e.start_ns * 1e-3, e.duration_ns * 1e-3);
+            out += buffer;
+            if (e.index >= 0) {
+                std::snprintf(buffer, sizeof(buffer), ",\"args\":{\"index\":%d}", e.index);
+                out += buffer;
+            }
+            out += '}';
+        }
+        if (clear) ring->tail.store(head, std::memory_order_relaxed);
+    }
+    out += "]}";
+    return out;
+}
@@ -0,0 +1,50 @@
+// Scoped trace events for timeline export (Chrome trace / Perfetto).
+// Pure C++ — no QuadriFlow headers; usable from every pipeline unit.
+//
+// Events are recorded into per-thread ring buffers without locks. While
+// tracing is disabled a TraceScope costs one relaxed atomic load and one
+// predictable branch.
+
+#ifndef PYQUADRIFLOW_TRACE_H
+#define PYQUADRIFLOW_TRACE_H
+
+#include <atomic>
+#include <cstdint>
+
+extern std::atomic<bool> g_tracing_enabled;
+
+inline bool TracingEnabled() {
+    return g_tracing_enabled.load(std::memory_order_relaxed);
+}
+
+int64_t TraceNow();  // nanoseconds on the trace clock
+
+// Append a complete event to the calling thread's ring. `name` must have
+// static storage duration (a string literal); `index` < 0 means none.
+void TraceRecord(const char* name, int index, int64_t start_ns);
+
+// Records [construction, destruction) as one event when tracing is on.
+class TraceScope {
+public:
+    explicit TraceScope(const char* name, int index = -1) {
+        if (TracingEnabled()) {
+            name_ = name;
+            index_ = index;
+            start_ = TraceNow();
+        }
+    }
+
+    ~TraceScope() {
+        if (name_) TraceRecord(name_, index_, start_);
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name_ = nullptr;
+    int index_ = -1;
+    int64_t start_ = 0;
+};
+
+#endif // PYQUADRIFLOW_TRACE_H
@@ -0,0 +1,291 @@
+/* Smoke test of the quadriflow_c ABI, built and registered with CTest under
+ * PYQUADRIFLOW_BUILD_C_API. Written in plain C against the public header
+ * only, as an embedding caller would. Exits nonzero on the first failure. */
+
+#include "quadriflow_c.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK(cond)                                                      \
+    do {                                                                 \
+        if (!(cond)) {                                                   \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed; last error: %s\n", \
+                    __FILE__, __LINE__, #cond, qf_last_error());         \
+            exit(1);                                                     \
+        }                                                                \
+    } while (0)
+
+#define RINGS 12
+#define SEGMENTS 24
+#define NUM_VERTICES (2 + (RINGS - 1) * SEGMENTS)
+#define NUM_FACES (2 * SEGMENTS * (RINGS - 1))
+
+static double g_vertices[NUM_VERTICES * 3];
+static int32_t g_faces[NUM_FACES * 3];
+
+/* Closed UV sphere: poles 0 and 1, then RINGS - 1 rings of SEGMENTS */
+static void BuildSphere(void) {
+    const double pi = 3.14159265358979323846;
+    int32_t* f = g_faces;
+    int r, s;
+    g_vertices[2] = 1;
+    g_vertices[5] = -1;
+    for (r = 1; r < RINGS; ++r) {
+        for (s = 0; s < SEGMENTS; ++s) {
+            const double theta = pi * r / RINGS, phi = 2 * pi * s / SEGMENTS;
+            double* v = g_vertices + 3 * (2 + (r - 1) * SEGMENTS + s);
+            v[0] = sin(theta) * cos(phi);
+            v[1] = sin(theta) * sin(phi);
+            v[2] = cos(theta);
+        }
+    }
+    for (s = 0; s < SEGMENTS; ++s) {
+        const int32_t next = (s + 1) % SEGMENTS;
+        const int32_t top = 2, bottom = 2 + (RINGS - 2) * SEGMENTS;
+        *f++ = 0; *f++ = top + s; *f++ = top + next;
+        *f++ = 1; *f++ = bottom + next; *f++ = bottom + s;
+        for (r = 1; r < RINGS - 1; ++r) {
+            const int32_t a = 2 + (r - 1) * SEGMENTS, b = a + SEGMENTS;
+            *f++ = a + s; *f++ = b + s; *f++ = b + next;
+            *f++ = a + s; *f++ = b + next; *f++ = a + next;
+        }
+    }
+}
+
+typedef struct Calls {
+    int progress;
+    int done;
+    int cancel_after;  /* cancel polls answered 0 before returning 1, or -1 */
+} Calls;
+
+static void OnProgress(const char* stage, double fraction, void* user_data) {
+    Calls* calls = (Calls*)user_data;
+    ++calls->progress;
+    if (strcmp(stage, "done") == 0 && fraction == 1.0) calls->done = 1;
+}
+
+static int OnCancel(void* user_data) {
+    Calls* calls = (Calls*)user_data;
+    if (calls->cancel_after < 0) return 0;
+    return calls->cancel_after-- == 0;
+}
+
+static qf_options Options(Calls* calls) {
+    qf_options options;
+    qf_options_init(&options);
+    options.target_faces = 200;
+    options.seed = 1;
+    options.progress = OnProgress;
+    options.cancel = OnCancel;
+    options.user_data = calls;
+    return options;
+}
+
+static qf_status Remesh(const qf_options* options, qf_result** result) {
+    return qf_remesh(g_vertices, NUM_VERTICES, g_faces, NUM_FACES, options, result);
+}
+
+static void TestArguments(void) {
+    Calls calls = {0, 0, -1};
+    qf_options options = Options(&calls);
+    qf_result* result = (qf_result*)&calls;  /* must be reset to NULL */
+
+    CHECK(qf_api_version() == QF_API_VERSION);
+    CHECK(options.struct_size == sizeof(qf_options));
+    CHECK(strcmp(qf_status_string(QF_ERROR_CANCELLED), "cancelled") == 0);
+
+    CHECK(qf_remesh(g_vertices, NUM_VERTICES, g_faces, NUM_FACES, &options, NULL) ==
+          QF_ERROR_INVALID_ARGUMENT);
+    CHECK(qf_remesh(NULL, NUM_VERTICES, g_faces, NUM_FACES, &options, &result) ==
+          QF_ERROR_INVALID_ARGUMENT);
+    CHECK(result == NULL);
+    CHECK(qf_last_error()[0] != '\0');
+    CHECK(qf_remesh(g_vertices, 0, g_faces, NUM_FACES, &options, &result) ==
+          QF_ERROR_INVALID_ARGUMENT);
+
+    options.target_faces = 0;
+    CHECK(Remesh(&options, &result) == QF_ERROR_INVALID_ARGUMENT);
+    options.target_faces = 200;
+    options.encode_position_bits = 33;
+    CHECK(Remesh(&options, &result) == QF_ERROR_INVALID_ARGUMENT);
+    options.encode_position_bits = 0;
+
+    g_faces[NUM_FACES * 3 - 1] = NUM_VERTICES;
+    CHECK(Remesh(&options, &result) == QF_ERROR_INVALID_ARGUMENT);
+    g_faces[NUM_FACES * 3 - 1] = -1;
+    CHECK(Remesh(&options, &result) == QF_ERROR_INVALID_ARGUMENT);
+    BuildSphere();
+
+    /* Options not set up by qf_options_init */
+    options.struct_size = 0;
+    CHECK(Remesh(&options, &result) == QF_ERROR_INVALID_ARGUMENT);
+    CHECK(result == NULL);
+
+    CHECK(qf_configure_thread_pool(-1, 0) == QF_ERROR_INVALID_ARGUMENT);
+}
+
+static void TestRemesh(void) {
+    Calls calls = {0, 0, -1};
+    const qf_options options = Options(&calls);
+    qf_result* result = NULL;
+    int64_t num_vertices, num_faces, i;
+    double* vertices;
+    int32_t* faces;
+    int64_t size = -1;
+
+    CHECK(Remesh(&options, &result) == QF_OK);
+    CHECK(result != NULL);
+    CHECK(qf_last_error()[0] == '\0');
+    CHECK(calls.progress > 1 && calls.done);
+
+    num_vertices = qf_result_num_vertices(result);
+    num_faces = qf_result_num_faces(result);
+    CHECK(num_vertices > 0 && num_faces > 0);
+    CHECK(qf_result_vertices(result) != NULL && qf_result_faces(result) != NULL);
+    CHECK(qf_result_encoded(result, &size) == NULL && size == 0);
+    CHECK(qf_result_degradations(result) == 0);
+    CHECK(qf_result_num_singularities(result) >= 0);
+    CHECK(qf_result_num_stages(result) > 0);
+    for (i = 0; i < qf_result_num_stages(result); ++i) {
+        CHECK(qf_result_stage_name(result, i) != NULL);
+        CHECK(qf_result_stage_seconds(result, i) >= 0);
+    }
+    CHECK(qf_result_stage_name(result, qf_result_num_stages(result)) == NULL);
+
+    /* Copies: one element short fails, exact capacity matches the views */
+    vertices = (double*)malloc(sizeof(double) * 3 * num_vertices);
+    faces = (int32_t*)malloc(sizeof(int32_t) * 4 * num_faces);
+    CHECK(vertices && faces);
+    CHECK(qf_result_copy_vertices(result, vertices, 3 * num_vertices - 1) ==
+          QF_ERROR_BUFFER_TOO_SMALL);
+    CHECK(qf_result_copy_faces(result, faces, 4 * num_faces - 1) == QF_ERROR_BUFFER_TOO_SMALL);
+    CHECK(qf_result_copy_vertices(result, vertices, 3 * num_vertices) == QF_OK);
+    CHECK(qf_result_copy_faces(result, faces, 4 * num_faces) == QF_OK);
+    CHECK(memcmp(vertices, qf_result_vertices(result), sizeof(double) * 3 * num_vertices) == 0);
+    CHECK(memcmp(faces, qf_result_faces(result), sizeof(int32_t) * 4 * num_faces) == 0);
+    for (i = 0; i < 4 * num_faces; ++i) CHECK(faces[i] >= 0 && faces[i] < num_vertices);
+
+    free(vertices);
+    free(faces);
+    qf_result_free(result);
+    qf_result_free(NULL);
+}
+
+/* A caller built against the first header, before the sweep options were
+ * appended: the fields past its struct_size must not be read */
+static void TestStructSize(void) {
+    Calls calls = {0, 0, -1};
+    qf_options options = Options(&calls);
+    qf_result* plain = NULL;
+    qf_result* old = NULL;
+
+    CHECK(Remesh(&options, &plain) == QF_OK);
+    options.struct_size = (uint32_t)offsetof(qf_options, domain_decomposition);
+    options.domain_decomposition = 1;
+    options.balanced_coloring = 1;
+    options.chaotic_relaxation = 1;
+    CHECK(Remesh(&options, &old) == QF_OK);
+
+    CHECK(qf_result_num_vertices(old) == qf_result_num_vertices(plain));
+    CHECK(qf_result_num_faces(old) == qf_result_num_faces(plain));
+    CHECK(memcmp(qf_result_vertices(old), qf_result_vertices(plain),
+                 sizeof(double) * 3 * qf_result_num_vertices(plain)) == 0);
+    qf_result_free(plain);
+    qf_result_free(old);
+}
+
+/* Init must not write past a version 1 caller's struct, whether it calls
+ * the sized entry point or the original exported function */
+static void TestOptionsInit(void) {
+    const size_t v1_size = offsetof(qf_options, domain_decomposition);
+    unsigned char buffer[sizeof(qf_options) + 16];
+    qf_options* options = (qf_options*)buffer;
+    Calls calls = {0, 0, -1};
+    qf_result* result = NULL;
+    size_t k, pass;
+
+    for (pass = 0; pass < 2; ++pass) {
+        memset(buffer, 0xab, sizeof(buffer));
+        if (pass == 0) {
+            qf_options_init_sized(options, v1_size);
+        } else {
+            (qf_options_init)(options);
+        }
+        CHECK(options->struct_size == v1_size);
+        CHECK(options->target_faces == 0 && options->progress == NULL && options->user_data == NULL);
+        for (k = v1_size; k < sizeof(buffer); ++k) CHECK(buffer[k] == 0xab);
+
+        options->target_faces = 200;
+        options->seed = 1;
+        options->user_data = &calls;
+        CHECK(Remesh(options, &result) == QF_OK);
+        qf_result_free(result);
+    }
+
+    /* A larger (newer) struct: the library's fields only */
+    memset(buffer, 0xab, sizeof(buffer));
+    qf_options_init_sized(options, sizeof(buffer));
+    CHECK(options->struct_size == sizeof(qf_options));
+    CHECK(options->chaotic_relaxation == 0);
+    for (k = sizeof(qf_options); k < sizeof(buffer); ++k) CHECK(buffer[k] == 0xab);
+
+    qf_options_init_sized(NULL, sizeof(qf_options));
+}
+
+static void TestCancel(void) {
+    const int after[] = {0, 3};
+    size_t k;
+    for (k = 0; k < sizeof(after) / sizeof(after[0]); ++k) {
+        Calls calls = {0, 0, after[k]};
+        const qf_options options = Options(&calls);
+        qf_result* result = NULL;
+        CHECK(Remesh(&options, &result) == QF_ERROR_CANCELLED);
+        CHECK(result == NULL);
+        CHECK(qf_last_error()[0] != '\0');
+        CHECK(!calls.done);
+    }
+}
+
+static void TestDegradations(void) {
+    const uint32_t known = QF_DEGRADE_SKIP_MINIMUM_COST_FLOW | QF_DEGRADE_SKIP_AGGRESSIVE_SAT |
+                           QF_DEGRADE_FEWER_ITERATIONS | QF_DEGRADE_COARSE_LEVELS_ONLY;
+    Calls calls = {0, 0, -1};
+    qf_options options = Options(&calls);
+    qf_result* result = NULL;
+
+    options.minimum_cost_flow = 1;
+    options.time_budget_ms = 1e-3;
+    CHECK(Remesh(&options, &result) == QF_OK);
+    CHECK(qf_result_degradations(result) & QF_DEGRADE_SKIP_MINIMUM_COST_FLOW);
+    CHECK((qf_result_degradations(result) & ~known) == 0);
+    qf_result_free(result);
+}
+
+static void TestThreadPool(void) {
+    Calls calls = {0, 0, -1};
+    const qf_options options = Options(&calls);
+    qf_result* result = NULL;
+
+    CHECK(qf_configure_thread_pool(2, 1) == QF_OK);
+    CHECK(Remesh(&options, &result) == QF_OK);
+    qf_result_free(result);
+    qf_shutdown();
+    CHECK(qf_configure_thread_pool(0, 0) == QF_OK);
+}
+
+int main(void) {
+    BuildSphere();
+    TestArguments();
+    TestRemesh();
+    TestStructSize();
+    TestOptionsInit();
+    TestCancel();
+    TestDegradations();
+    TestThreadPool();
+    qf_shutdown();
+    printf("c_api_test: all checks passed\n");
+    return 0;
+}
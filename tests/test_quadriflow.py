@@ -1,5 +1,7 @@
 """Tests for pyquadriflow: QuadriFlow quad-dominant remeshing."""
 
+import os
+
 import numpy as np
 import pytest
 
@@ -73,6 +75,846 @@ def test_quadriflow_cube(cube):
     assert len(v_out) > 0
 
 
+# ── Stats & Time Budget ──────────────────────────────────────────────
+
+
+def test_quadriflow_stats(icosphere):
+    """Test that per-stage timings are reported."""
+    import pyquadriflow
+
+    verts, faces = icosphere
+    v_out, f_out, stats = pyquadriflow.quadriflow_remesh(
+        verts, faces, target_faces=100, return_stats=True)
+
+    assert len(f_out) > 0
+    for name in ("load", "initialize", "orientations", "positions", "extraction"):
+        assert stats["stages"][name] >= 0
+    assert stats["total_seconds"] >= 0
+    assert stats["degradations"] == []
+
+
+def test_quadriflow_time_budget_degrades(cube):
+    """Test that an unmeetable budget still returns a mesh, with degradations."""
+    import pyquadriflow
+
+    verts, faces = cube
+    v_out, f_out, stats = pyquadriflow.quadriflow_remesh(
+        verts, faces, target_faces=50,
+        minimum_cost_flow=True, aggressive_sat=True,
+        time_budget_ms=1e-3, return_stats=True)
+
+    assert f_out.shape[1] == 4
+    assert len(f_out) > 0
+    assert "skip_minimum_cost_flow" in stats["degradations"]
+    assert "skip_aggressive_sat" in stats["degradations"]
+
+
+def test_quadriflow_generous_budget_matches(icosphere):
+    """Test that a budget which is never hit leaves the output unchanged."""
+    import pyquadriflow
+
+    verts, faces = icosphere
+    v1, f1 = pyquadriflow.quadriflow_remesh(verts, faces, target_faces=100, seed=3)
+    v2, f2, stats = pyquadriflow.quadriflow_remesh(
+        verts, faces, target_faces=100, seed=3,
+        time_budget_ms=1e7, return_stats=True)
+
+    assert stats["degradations"] == []
+    np.testing.assert_array_equal(v1, v2)
+    np.testing.assert_array_equal(f1, f2)
+
+
+def test_quadriflow_allocation_stats(icosphere):
+    """Test per-stage allocation counts (PYQUADRIFLOW_ALLOC_STATS builds)."""
+    import pyquadriflow
+
+    verts, faces = icosphere
+    _, _, stats = pyquadriflow.quadriflow_remesh(
+        verts, faces, target_faces=100, return_stats=True)
+    if "allocations" not in stats:
+        pytest.skip("built without PYQUADRIFLOW_ALLOC_STATS")
+
+    assert set(stats["allocations"]) == set(stats["stages"])
+    initialize = stats["allocations"]["initialize"]
+    assert initialize["allocations"] > 0
+    assert initialize["peak_bytes"] > 0
+    assert initialize["bytes_allocated"] >= initialize["peak_bytes"]
+
+
+def test_quadriflow_hardware_counters(icosphere):
+    """Test per-stage perf counters, or their absence where not permitted."""
+    import pyquadriflow
+
+    verts, faces = icosphere
+    available = pyquadriflow.enable_hardware_counters(True)
+    try:
+        _, _, stats = pyquadriflow.quadriflow_remesh(
+            verts, faces, target_faces=100, return_stats=True)
+    finally:
+        pyquadriflow.enable_hardware_counters(False)
+
+    if not available:
+        assert "counters" not in stats
+        return
+    assert set(stats["counters"]) == set(stats["stages"])
+    initialize = stats["counters"]["initialize"]
+    assert initialize["cycles"] > 0
+    if "ipc" in initialize:
+        assert initialize["ipc"] > 0
+
+    _, _, stats = pyquadriflow.quadriflow_remesh(
+        verts, faces, target_faces=100, return_stats=True)
+    assert "counters" not in stats
+
+
+def test_quadriflow_working_vertices(icosphere):
+    """Test that the per-element counter divisor is the working mesh size."""
+    import pyquadriflow
+
+    verts, faces = icosphere
+    _, _, stats = pyquadriflow.quadriflow_remesh(
+        verts, faces, target_faces=100, return_stats=True)
+    # Every finest-level vertex is in exactly one smoothing phase
+    assert stats["working_vertices"] > 0
+    assert stats["working_vertices"] == sum(stats["phase_sizes"][0])
+
+
+def test_quadriflow_hugepages(icosphere):
+    """Test that huge pages only change placement, never the result."""
+    import pyquadriflow
+
+    verts, faces = icosphere
+    pyquadriflow.enable_hugepages(True)
+    v_on, f_on, stats = pyquadriflow.quadriflow_remesh(
+        verts, faces, target_faces=100, seed=5, return_stats=True)
+    assert "hugepages" in stats["stages"]
+
+    pyquadriflow.enable_hugepages(False)
+    try:
+        v_off, f_off, stats = pyquadriflow.quadriflow_remesh(
+            verts, faces, target_faces=100, seed=5, return_stats=True)
+    finally:
+        pyquadriflow.enable_hugepages(True)
+    assert "hugepages" not in stats["stages"]
+    np.testing.assert_array_equal(v_on, v_off)
+    np.testing.assert_array_equal(f_on, f_off)
+
+
+def test_quadriflow_reorder_output(icosphere):
+    """Test that reorder_output only permutes faces and vertices."""
+    import pyquadriflow
+
+    verts, faces = icosphere
+    v1, f1 = pyquadriflow.quadriflow_remesh(verts, faces, target_faces=100, seed=7)
+    v2, f2, stats = pyquadriflow.quadriflow_remesh(
+        verts, faces, target_faces=100, seed=7, reorder_output=True, return_stats=True)
+
+    assert "reorder" in stats["stages"]
+    assert f1.shape == f2.shape and v1.shape == v2.shape
+    # Vertices are numbered in order of first use
+    _, first_use = np.unique(f2.reshape(-1), return_index=True)
+    assert np.all(np.diff(first_use) > 0)
+    # Same set of quads (as sorted corner positions)
+    def quad_keys(v, f):
+        return sorted(tuple(np.round(np.sort(v[q], axis=0), 9).ravel()) for q in f)
+    assert quad_keys(v1, f1) == quad_keys(v2, f2)
+
+
+def test_chrome_trace_export(icosphere, tmp_path):
+    """Test that enabled tracing records stages and sub-stages."""
+    import json
+
+    import pyquadriflow
+
+    verts, faces = icosphere
+    pyquadriflow.export_chrome_trace()  # drop anything recorded earlier
+    pyquadriflow.enable_tracing(True)
+    try:
+        pyquadriflow.quadriflow_remesh(verts, faces, target_faces=100)
+    finally:
+        pyquadriflow.enable_tracing(False)
+
+    path = tmp_path / "trace.json"
+    trace = json.loads(pyquadriflow.export_chrome_trace(path))
+    names = {e["name"] for e in trace["traceEvents"]}
+    assert {"load", "orientations", "orientations.level", "positions.sweep"} <= names
+    assert all(e["ph"] == "X" and e["dur"] >= 0 for e in trace["traceEvents"])
+    assert json.loads(path.read_text()) == trace
+
+    # Cleared by the export; nothing is recorded while disabled
+    pyquadriflow.quadriflow_remesh(verts, faces, target_faces=100)
+    assert json.loads(pyquadriflow.export_chrome_trace())["traceEvents"] == []
+
+
+def test_cumulative_metrics(icosphere):
+    """Test the process-wide metrics registry and its Prometheus export."""
+    import urllib.request
+
+    import pyquadriflow
+    from pyquadriflow import _pyquadriflow
+
+    verts, faces = icosphere
+    pyquadriflow.reset_metrics()
+    for _ in range(2):
+        pyquadriflow.quadriflow_remesh(verts, faces, target_faces=100)
+    with pytest.raises(RuntimeError):
+        _pyquadriflow.quadriflow_remesh(verts, faces, target_faces=0)
+
+    metrics = pyquadriflow.get_metrics()
+    assert metrics["calls"] == 3
+    assert metrics["failures"] == 1
+    assert metrics["input_faces"] == 3 * len(faces)
+    assert metrics["output_faces"] > 0
+    assert metrics["peak_memory_bytes"] > 0
+    initialize = metrics["stages"]["initialize"]
+    assert initialize["count"] == 2
+    bounds = [b for b, _ in initialize["buckets"]]
+    counts = [c for _, c in initialize["buckets"]]
+    assert bounds == sorted(bounds) and counts == sorted(counts)
+    assert counts[-1] <= initialize["count"]
+
+    server = pyquadriflow.serve_metrics(port=0)
+    try:
+        host, port = server.server_address[:2]
+        with urllib.request.urlopen(f"http://{host}:{port}/metrics") as response:
+            text = response.read().decode()
+    finally:
+        server.shutdown()
+    assert text == pyquadriflow.prometheus_metrics()
+    assert "quadriflow_calls_total 3\n" in text
+    assert 'quadriflow_stage_seconds_count{stage="initialize"} 2\n' in text
+
+    pyquadriflow.reset_metrics()
+    metrics = pyquadriflow.get_metrics()
+    assert metrics["calls"] == 0
+    assert all(stage["count"] == 0 for stage in metrics["stages"].values())
+
+
+# ── Preview & Session ────────────────────────────────────────────────
+
+
+def test_quadriflow_preview(icosphere):
+    """Test the one-shot approximate preview path."""
+    import pyquadriflow
+
+    verts, faces = icosphere
+    v_out, f_out, stats = pyquadriflow.quadriflow_remesh(
+        verts, faces, target_faces=100, preview=True, return_stats=True)
+
+    assert v_out.shape[1] == 3
+    assert f_out.shape[1] == 4
+    assert len(f_out) > 0
+    assert np.all(f_out >= 0) and np.all(f_out < len(v_out))
+    assert "scale" not in stats["stages"]
+
+
+def test_remesher_preview_then_full(icosphere):
+    """Test that a session previews repeatedly and then runs full quality."""
+    import pyquadriflow
+
+    verts, faces = icosphere
+    r = pyquadriflow.Remesher(verts, faces, seed=1)
+
+    for target in (100, 60, 100):
+        v_out, f_out = r.preview(target)
+        assert len(f_out) > 0
+
+    v_out, f_out, stats = r.remesh(100, return_stats=True)
+    assert f_out.shape[1] == 4
+    assert len(f_out) > 0
+    # The hierarchy was built by the first preview and reused
+    assert "initialize" not in stats["stages"]
+
+    # A second full run starts afresh
+    v2, f2 = r.remesh(100)
+    assert len(f2) > 0
+
+
+def test_remesh_from_threads(icosphere):
+    """Test that calls from several threads at once, sharing a session too, match serial ones."""
+    import threading
+
+    import pyquadriflow
+
+    verts, faces = icosphere
+    v_ref, f_ref = pyquadriflow.quadriflow_remesh(verts, faces, target_faces=100, seed=3)
+    r = pyquadriflow.Remesher(verts, faces, seed=3)
+    _, fp_ref = r.preview(100)
+
+    results, previews = [], []
+
+    def work():
+        results.append(pyquadriflow.quadriflow_remesh(verts, faces, target_faces=100, seed=3))
+        previews.append(r.preview(100))
+
+    threads = [threading.Thread(target=work) for _ in range(4)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+
+    assert len(results) == len(previews) == 4
+    for v_out, f_out in results:
+        np.testing.assert_array_equal(v_out, v_ref)
+        np.testing.assert_array_equal(f_out, f_ref)
+    for _, f_prev in previews:
+        np.testing.assert_array_equal(f_prev, fp_ref)
+
+
+def test_remesher_continues_from_preview_level(icosphere):
+    """Test that remesh starts from the preview's fields, not over them."""
+    import pyquadriflow
+
+    verts, faces = icosphere
+    r = pyquadriflow.Remesher(verts, faces, seed=1)
+    assert r.preview_level is None
+    r.preview(100)
+    level = r.preview_level
+    assert level is not None
+
+    views = [r.field("O", l) for l in range(level, r.num_levels)]
+    solved = [v.copy() for v in views]
+    r.remesh(100)
+    assert r.preview_level is None
+    # The preview's positions were prolonged down, not overwritten from above
+    for view, before in zip(views, solved):
+        np.testing.assert_array_equal(view, before)
+
+
+def test_remesher_field_views(icosphere):
+    """Test zero-copy, read-only field views on a session."""
+    import pyquadriflow
+
+    verts, faces = icosphere
+    r = pyquadriflow.Remesher(verts, faces)
+    assert r.num_levels == 0
+    r.preview(target_faces=100)
+
+    assert r.num_levels > 1
+    N = r.field("N")
+    Q = r.field("Q", level=1)
+    assert N.shape[1] == 3 and r.field("S").shape[1] == 2
+    assert not N.flags.writeable
+    np.testing.assert_allclose(np.linalg.norm(N, axis=1), 1.0, atol=1e-6)
+    # Orientations are tangent to the surface
+    N1 = r.field("N", level=1)
+    assert np.all(np.abs(np.sum(Q * N1, axis=1)) < 1e-6)
+
+    offset, scale = r.normalization
+    V = r.field("V")
+    assert np.abs(V * scale + offset).max() == pytest.approx(np.abs(verts).max(), rel=0.05)
+
+    # Views stay valid after the session goes away
+    del r
+    assert np.isfinite(N).all()
+
+
+def test_remesher_pickle_out_of_band(icosphere):
+    """Test that a previewed session pickles out-of-band and resumes identically."""
+    import pickle
+
+    import pyquadriflow
+
+    verts, faces = icosphere
+    r = pyquadriflow.Remesher(verts, faces, seed=3)
+    r.preview(target_faces=100)
+
+    buffers = []
+    data = pickle.dumps(r, protocol=5, buffer_callback=buffers.append)
+    assert len(buffers) > 10
+    assert len(data) < sum(b.raw().nbytes for b in buffers)
+
+    restored = pickle.loads(data, buffers=buffers)
+    assert restored.num_levels == r.num_levels
+    np.testing.assert_array_equal(restored.field("O", 1), r.field("O", 1))
+
+    # Continues from the restored fields without rebuilding the hierarchy
+    v_out, f_out, stats = restored.remesh(100, return_stats=True)
+    assert "initialize" not in stats["stages"]
+    v_ref, f_ref = r.remesh(100)
+    np.testing.assert_array_equal(v_out, v_ref)
+    np.testing.assert_array_equal(f_out, f_ref)
+
+    # In-band protocols work too; an unbuilt session pickles its input only
+    fresh = pickle.loads(pickle.dumps(pyquadriflow.Remesher(verts, faces), protocol=4))
+    assert fresh.num_levels == 0 and len(fresh.remesh(100)[1]) > 0
+
+
+def test_remesher_rejects_corrupt_state(icosphere):
+    """Test that out-of-range indices in a saved state raise instead of being followed."""
+    import pyquadriflow
+    from pyquadriflow import _pyquadriflow
+
+    verts, faces = icosphere
+    r = pyquadriflow.Remesher(verts, faces, seed=3)
+    r.preview(target_faces=100)
+    scalars, arrays = r._native.save_state()
+
+    for name in ("F", "hierarchy.mAdj.0.items", "hierarchy.mPhases.1.items",
+                 "hierarchy.mToUpper.0", "hierarchy.mToLower.0"):
+        corrupt = []
+        for array in arrays:
+            if array[0] == name:
+                data = array[4].copy()
+                data.view(np.int32)[0] = 1 << 30
+                array = (*array[:4], data)
+            corrupt.append(array)
+        with pytest.raises(RuntimeError, match="out of range"):
+            _pyquadriflow.Remesher.from_state(scalars, corrupt)
+
+    # Unmodified, the same state restores
+    assert _pyquadriflow.Remesher.from_state(scalars, arrays).num_levels == r.num_levels
+
+
+def test_result_arrays_pickle_out_of_band(icosphere):
+    """Test that result arrays travel as out-of-band buffers with protocol 5."""
+    import pickle
+
+    import pyquadriflow
+
+    verts, faces = icosphere
+    result = pyquadriflow.quadriflow_remesh(verts, faces, target_faces=100)
+    buffers = []
+    data = pickle.dumps(result, protocol=5, buffer_callback=buffers.append)
+    assert len(buffers) == 2
+
+    v_out, f_out = pickle.loads(data, buffers=buffers)
+    np.testing.assert_array_equal(v_out, result[0])
+    np.testing.assert_array_equal(f_out, result[1])
+
+
+# ── Multi-Seed ───────────────────────────────────────────────────────
+
+
+def test_quadriflow_seeds_best(icosphere):
+    """Test that best-of-N returns the candidate with fewest singularities."""
+    import pyquadriflow
+
+    verts, faces = icosphere
+    seeds = [0, 1, 2, 3]
+    all_results = pyquadriflow.quadriflow_remesh(
+        verts, faces, target_faces=100, seeds=seeds, return_all=True)
+    assert [stats["seed"] for _, _, stats in all_results] == seeds
+
+    v_best, f_best, stats = pyquadriflow.quadriflow_remesh(
+        verts, faces, target_faces=100, seeds=seeds, return_stats=True)
+    fewest = min(s["singularities"] for _, _, s in all_results)
+    assert stats["singularities"] == fewest
+    assert stats["seed"] in seeds
+    assert f_best.shape[1] == 4 and len(f_best) > 0
+
+
+def test_quadriflow_seeds_reproducible(icosphere):
+    """Test that multi-seed results are deterministic despite threading."""
+    import pyquadriflow
+
+    verts, faces = icosphere
+    v1, f1 = pyquadriflow.quadriflow_remesh(verts, faces, target_faces=100, seeds=[5, 6])
+    v2, f2 = pyquadriflow.quadriflow_remesh(verts, faces, target_faces=100, seeds=[5, 6])
+
+    np.testing.assert_array_equal(v1, v2)
+    np.testing.assert_array_equal(f1, f2)
+
+
+# ── Batch ────────────────────────────────────────────────────────────
+
+
+def test_quadriflow_batch_matches_single(icosphere, cube):
+    """Test that batch results equal one-at-a-time remeshing, in input order."""
+    import pyquadriflow
+
+    meshes = [icosphere, cube, (icosphere[0] * 2.0, icosphere[1])]
+    results = pyquadriflow.quadriflow_remesh_batch(
+        meshes, target_faces=100, seed=2, max_workers=2, return_stats=True)
+    assert len(results) == len(meshes)
+
+    for (verts, faces), (v_out, f_out, stats) in zip(meshes, results):
+        v_ref, f_ref = pyquadriflow.quadriflow_remesh(verts, faces, target_faces=100, seed=2)
+        np.testing.assert_array_equal(v_out, v_ref)
+        np.testing.assert_array_equal(f_out, f_ref)
+        assert stats["numa_node"] >= 0
+
+    assert pyquadriflow.quadriflow_remesh_batch([], target_faces=100) == []
+    with pytest.raises(ValueError):
+        pyquadriflow.quadriflow_remesh_batch(meshes, target_faces=100, max_workers=0)
+
+
+# ── Thread Pool ──────────────────────────────────────────────────────
+
+
+def test_thread_pool_reconfigure_keeps_results(icosphere):
+    """Test that resizing, pinning and shutting down the pool leave results unchanged."""
+    import pyquadriflow
+
+    verts, faces = icosphere
+    v_ref, f_ref = pyquadriflow.quadriflow_remesh(verts, faces, target_faces=100, seeds=[5, 6])
+
+    try:
+        pyquadriflow.configure_thread_pool(2, pin_threads=True)
+        v_out, f_out = pyquadriflow.quadriflow_remesh(verts, faces, target_faces=100, seeds=[5, 6])
+        np.testing.assert_array_equal(v_out, v_ref)
+        np.testing.assert_array_equal(f_out, f_ref)
+
+        pyquadriflow.shutdown()
+        v_out, f_out = pyquadriflow.quadriflow_remesh(verts, faces, target_faces=100, seeds=[5, 6])
+        np.testing.assert_array_equal(v_out, v_ref)
+        np.testing.assert_array_equal(f_out, f_ref)
+    finally:
+        pyquadriflow.configure_thread_pool()
+
+    with pytest.raises(ValueError):
+        pyquadriflow.configure_thread_pool(0)
+
+
+@pytest.mark.skipif(not hasattr(os, "fork"), reason="needs fork()")
+def test_thread_pool_after_fork(icosphere):
+    """Test that a child forked after the pool started remeshes in parallel."""
+    import pyquadriflow
+
+    verts, faces = icosphere
+    pyquadriflow.quadriflow_remesh(verts, faces, target_faces=100, seeds=[5, 6])
+
+    pid = os.fork()
+    if pid == 0:
+        status = 1
+        try:
+            pyquadriflow.quadriflow_remesh(verts, faces, target_faces=100, seeds=[5, 6])
+            status = 0
+        finally:
+            os._exit(status)
+
+    _, status = os.waitpid(pid, 0)
+    assert os.WIFEXITED(status) and os.WEXITSTATUS(status) == 0
+
+
+def test_domain_decomposition_thread_independent(icosphere):
+    """Test that domain-decomposed smoothing gives quads independent of the pool size."""
+    import pyquadriflow
+
+    verts, faces = icosphere
+    # Enough faces for the finest levels to split into several blocks
+    try:
+        pyquadriflow.configure_thread_pool(1)
+        v_ref, f_ref = pyquadriflow.quadriflow_remesh(
+            verts, faces, target_faces=20000, domain_decomposition=True)
+        pyquadriflow.configure_thread_pool(4)
+        v_out, f_out = pyquadriflow.quadriflow_remesh(
+            verts, faces, target_faces=20000, domain_decomposition=True)
+    finally:
+        pyquadriflow.configure_thread_pool()
+
+    assert f_ref.shape[1] == 4 and len(f_ref) > 0
+    np.testing.assert_array_equal(v_out, v_ref)
+    np.testing.assert_array_equal(f_out, f_ref)
+
+    with pytest.raises(ValueError):
+        pyquadriflow.quadriflow_remesh(
+            verts, faces, target_faces=100, domain_decomposition=True, seeds=[1, 2])
+
+
+def test_domain_decomposition_everywhere(icosphere):
+    """Test that sessions, builders, previews and masks take domain_decomposition."""
+    import pickle
+
+    import pyquadriflow
+
+    verts, faces = icosphere
+    _, f_out = pyquadriflow.quadriflow_remesh(
+        verts, faces, target_faces=100, domain_decomposition=True, preview=True)
+    assert f_out.shape[1] == 4 and len(f_out) > 0
+
+    r = pyquadriflow.Remesher(verts, faces, domain_decomposition=True)
+    r.preview(100)
+    scalars, _ = r._native.save_state()
+    assert scalars["options.domain_decomposition"] == 1
+    restored = pickle.loads(pickle.dumps(r, protocol=5))
+    v_ref, f_ref = r.remesh(100)
+    v_out, f_out = restored.remesh(100)
+    np.testing.assert_array_equal(v_out, v_ref)
+    np.testing.assert_array_equal(f_out, f_ref)
+
+    builder = pyquadriflow.MeshBuilder()
+    builder.add_chunk(verts, faces)
+    _, f_out = builder.remesh(target_faces=100, domain_decomposition=True)
+    assert f_out.shape[1] == 4 and len(f_out) > 0
+
+    mask = verts[faces].mean(axis=1)[:, 2] > 0
+    _, q_out, _ = pyquadriflow.quadriflow_remesh(
+        verts, faces, target_faces=50, face_mask=mask, domain_decomposition=True)
+    assert q_out.shape[1] == 4 and len(q_out) > 0
+
+    with pytest.raises(ValueError):
+        pyquadriflow.Remesher(verts, faces, domain_decomposition=True, chaotic_relaxation=True)
+
+
+def test_balanced_coloring_phase_sizes(icosphere):
+    """Test that balanced recolouring evens out the phases, independently of the pool size."""
+    import pyquadriflow
+
+    verts, faces = icosphere
+    _, _, stats = pyquadriflow.quadriflow_remesh(
+        verts, faces, target_faces=2000, return_stats=True)
+    default = stats["phase_sizes"]
+    assert len(default) > 1 and all(size > 0 for level in default for size in level)
+
+    try:
+        pyquadriflow.configure_thread_pool(1)
+        v_ref, f_ref, stats = pyquadriflow.quadriflow_remesh(
+            verts, faces, target_faces=2000, balanced_coloring=True, return_stats=True)
+        pyquadriflow.configure_thread_pool(4)
+        v_out, f_out = pyquadriflow.quadriflow_remesh(
+            verts, faces, target_faces=2000, balanced_coloring=True)
+    finally:
+        pyquadriflow.configure_thread_pool()
+
+    balanced = stats["phase_sizes"]
+    assert "coloring" in stats["stages"]
+    assert [sum(level) for level in balanced] == [sum(level) for level in default]
+
+    np.testing.assert_array_equal(v_out, v_ref)
+    np.testing.assert_array_equal(f_out, f_ref)
+
+    # Largest over smallest phase. A handful of vertices leaves the balancing
+    # little room, so only levels with enough of them are compared
+    def spread(phases):
+        return max(phases) / min(phases)
+    large = [i for i, phases in enumerate(default) if sum(phases) >= 500]
+    assert large
+    for i, phases in enumerate(default):
+        if sum(phases) >= 64:
+            assert spread(balanced[i]) <= spread(phases)
+    for i in large:
+        assert spread(balanced[i]) <= 1.5
+
+
+def test_balanced_coloring_everywhere(icosphere):
+    """Test that sessions, builders, previews and masks take balanced_coloring."""
+    import pyquadriflow
+
+    verts, faces = icosphere
+    _, _, stats = pyquadriflow.quadriflow_remesh(
+        verts, faces, target_faces=100, balanced_coloring=True, preview=True, return_stats=True)
+    assert "coloring" in stats["stages"]
+
+    r = pyquadriflow.Remesher(verts, faces, balanced_coloring=True)
+    _, _, stats = r.preview(100, return_stats=True)
+    assert "coloring" in stats["stages"]
+    scalars, _ = r._native.save_state()
+    assert scalars["options.balanced_coloring"] == 1
+
+    builder = pyquadriflow.MeshBuilder()
+    builder.add_chunk(verts, faces)
+    _, _, stats = builder.remesh(target_faces=100, balanced_coloring=True, return_stats=True)
+    assert "coloring" in stats["stages"]
+
+    mask = verts[faces].mean(axis=1)[:, 2] > 0
+    *_, stats = pyquadriflow.quadriflow_remesh(
+        verts, faces, target_faces=50, face_mask=mask, balanced_coloring=True,
+        return_stats=True)
+    assert "coloring" in stats["stages"]
+
+
+def test_chaotic_relaxation(icosphere):
+    """Test that chaotic relaxation still produces quad meshes, previews included."""
+    import pyquadriflow
+
+    verts, faces = icosphere
+    for preview in (False, True):
+        v_out, f_out = pyquadriflow.quadriflow_remesh(
+            verts, faces, target_faces=200, chaotic_relaxation=True, preview=preview)
+        assert f_out.shape[1] == 4 and len(f_out) > 0
+        assert f_out.min() >= 0 and f_out.max() < len(v_out)
+
+    with pytest.raises(ValueError):
+        pyquadriflow.quadriflow_remesh(
+            verts, faces, target_faces=200, chaotic_relaxation=True, seeds=[1, 2])
+
+
+# ── Region of Interest ───────────────────────────────────────────────
+
+
+def test_quadriflow_face_mask(cube):
+    """Test that only the masked region is remeshed and the rest is kept."""
+    import pyquadriflow
+
+    verts, faces = cube
+    centroids = verts[faces].mean(axis=1)
+    mask = centroids[:, 2] > 0.5  # top of the cube
+
+    v_out, q_out, t_out = pyquadriflow.quadriflow_remesh(
+        verts, faces, target_faces=20, face_mask=mask)
+
+    assert q_out.shape[1] == 4 and len(q_out) > 0
+    assert t_out.shape[1] == 3
+    # Untouched triangles come first and keep their positions
+    kept = faces[~mask]
+    assert len(t_out) >= len(kept)
+    np.testing.assert_array_equal(v_out[t_out[:len(kept)]], verts[kept])
+    assert np.all(t_out < len(v_out)) and np.all(q_out < len(v_out))
+
+
+def test_quadriflow_face_mask_validation(cube):
+    """Test face_mask length validation."""
+    import pyquadriflow
+
+    verts, faces = cube
+    with pytest.raises(ValueError):
+        pyquadriflow.quadriflow_remesh(
+            verts, faces, target_faces=20, face_mask=np.ones(3, dtype=bool))
+
+
+def test_quadriflow_face_mask_index_out_of_range(cube):
+    """Test that bad indices outside the masked region are rejected too."""
+    import pyquadriflow
+
+    verts, faces = cube
+    mask = np.zeros(len(faces), dtype=bool)
+    mask[:len(faces) // 2] = True
+    for bad in (len(verts), -1):
+        broken = faces.copy()
+        broken[-1, 0] = bad
+        with pytest.raises(RuntimeError, match="out of range"):
+            pyquadriflow.quadriflow_remesh(
+                verts, broken, target_faces=20, face_mask=mask)
+
+
+# ── Chunked Input ────────────────────────────────────────────────────
+
+
+def _split_into_chunks(verts, faces, n):
+    """Split a mesh into n face ranges, each with its own vertex array."""
+    chunks = []
+    for part in np.array_split(faces, n):
+        used, local = np.unique(part, return_inverse=True)
+        chunks.append((verts[used], local.reshape(-1, 3)))
+    return chunks
+
+
+def test_mesh_builder_welds_chunks(icosphere):
+    """Test that seam vertices duplicated across chunks are welded."""
+    import pyquadriflow
+
+    verts, faces = icosphere
+    builder = pyquadriflow.MeshBuilder()
+    for chunk_verts, chunk_faces in _split_into_chunks(verts, faces, 4):
+        builder.add_chunk(chunk_verts, chunk_faces)
+
+    assert builder.num_vertices == len(np.unique(faces))
+    assert builder.num_faces == len(faces)
+
+    v_out, f_out = builder.remesh(target_faces=100)
+    assert f_out.shape[1] == 4 and len(f_out) > 0
+    assert builder.num_faces == 0
+
+
+def test_mesh_builder_tolerance(icosphere):
+    """Test that weld_tolerance welds slightly perturbed seams."""
+    import pyquadriflow
+
+    verts, faces = icosphere
+    exact = pyquadriflow.MeshBuilder()
+    welded = pyquadriflow.MeshBuilder(weld_tolerance=1e-6)
+    for i, (chunk_verts, chunk_faces) in enumerate(_split_into_chunks(verts, faces, 2)):
+        chunk_verts = chunk_verts + i * 1e-9
+        exact.add_chunk(chunk_verts, chunk_faces)
+        welded.add_chunk(chunk_verts, chunk_faces)
+
+    assert welded.num_vertices == len(np.unique(faces))
+    assert exact.num_vertices > welded.num_vertices
+
+
+# ── Quantized Format ─────────────────────────────────────────────────
+
+
+def test_encode_decode_roundtrip(icosphere):
+    """Test that the quantized format keeps faces and bounds position error."""
+    import pyquadriflow
+
+    verts, faces = icosphere
+    v_out, f_out = pyquadriflow.quadriflow_remesh(verts, faces, target_faces=100)
+
+    encoded = pyquadriflow.encode_mesh(v_out, f_out, position_bits=16)
+    assert len(encoded) < v_out.nbytes + f_out.nbytes
+    v_dec, f_dec = pyquadriflow.decode_mesh(encoded)
+
+    np.testing.assert_array_equal(f_dec, f_out)
+    extent = v_out.max(axis=0) - v_out.min(axis=0)
+    assert np.all(np.abs(v_dec - v_out) <= extent / (2**16 - 1))
+
+    with pytest.raises((ValueError, RuntimeError)):
+        pyquadriflow.decode_mesh(encoded[:-1])
+
+
+def test_quadriflow_encode_position_bits(icosphere):
+    """Test encoding straight from the pipeline."""
+    import pyquadriflow
+
+    verts, faces = icosphere
+    v_out, f_out = pyquadriflow.quadriflow_remesh(verts, faces, target_faces=100, seed=3)
+    encoded, stats = pyquadriflow.quadriflow_remesh(
+        verts, faces, target_faces=100, seed=3, encode_position_bits=14, return_stats=True)
+
+    assert isinstance(encoded, bytes)
+    assert "encode" in stats["stages"]
+    v_dec, f_dec = pyquadriflow.decode_mesh(encoded)
+    np.testing.assert_array_equal(f_dec, f_out)
+    np.testing.assert_allclose(v_dec, v_out, atol=1e-3)
+
+
+def test_decode_rejects_oversized_face_count(icosphere):
+    """Test that a header claiming 2^28 faces is rejected before allocating."""
+    import pyquadriflow
+
+    verts, faces = icosphere
+    v_out, f_out = pyquadriflow.quadriflow_remesh(verts, faces, target_faces=100)
+    encoded = bytearray(pyquadriflow.encode_mesh(v_out, f_out, position_bits=16))
+    encoded[16:24] = (2**28).to_bytes(8, "little")
+
+    with pytest.raises((ValueError, RuntimeError)):
+        pyquadriflow.decode_mesh(bytes(encoded))
+
+
+# ── Large Meshes ─────────────────────────────────────────────────────
+
+
+def test_solver_limit_rejected(icosphere):
+    """Test that meshes past the solver's int32 indexing fail cleanly."""
+    import pyquadriflow
+
+    verts, _ = icosphere
+    try:
+        # Untouched zero pages: no physical memory until written
+        faces = np.zeros((0x7FFFFFFF // 3 + 1, 3), dtype=np.int32)
+    except MemoryError:
+        pytest.skip("cannot reserve a 2^31-index face array")
+    assert faces.size > 2**31 - 1
+
+    with pytest.raises(RuntimeError, match="too large"):
+        pyquadriflow.quadriflow_remesh(verts, faces, target_faces=100)
+
+
+@pytest.mark.skipif(os.environ.get("PYQUADRIFLOW_LARGE_TESTS") != "1",
+                    reason="set PYQUADRIFLOW_LARGE_TESTS=1; needs ~32 GB of RAM")
+def test_roi_beyond_solver_limit(icosphere):
+    """Test ROI remeshing of a region inside a mesh past the solver limit."""
+    import pyquadriflow
+
+    verts, faces = icosphere
+    padding = 0x7FFFFFFF // 3 + 1
+    big_faces = np.empty((len(faces) + padding, 3), dtype=np.int32)
+    big_faces[:len(faces)] = faces
+    big_faces[len(faces):] = faces[0]
+    mask = np.zeros(len(big_faces), dtype=bool)
+    mask[:len(faces) // 2] = True
+
+    v_out, q_out, t_out = pyquadriflow.quadriflow_remesh(
+        verts, big_faces, target_faces=100, face_mask=mask)
+    assert v_out.shape[1] == 3
+    assert q_out.shape[1] == 4
+    assert t_out.shape[1] == 3
+    assert len(t_out) >= padding
+
+
 # ── Input Validation ─────────────────────────────────────────────────
 
 
@@ -129,3 +971,77 @@ def test_quadriflow_input_validation_target_faces():
 
     with pytest.raises((ValueError, RuntimeError)):
         pyquadriflow.quadriflow_remesh(verts, faces, target_faces=-5)
+
+
+# ── Resource Estimation ──────────────────────────────────────────────
+
+
+def test_estimate_resources_analysis(cube):
+    """Test input analysis of a closed single-component mesh."""
+    import pyquadriflow
+
+    verts, faces = cube
+    est = pyquadriflow.estimate_resources(verts, faces, target_faces=50)
+
+    assert est["num_components"] == 1
+    assert est["num_boundary_edges"] == 0
+    assert est["boundary_length"] == 0.0
+    assert est["surface_area"] > 0
+    assert est["working_faces"] >= len(faces)
+    assert est["peak_memory_bytes"] > 0
+    assert est["runtime_seconds"] > 0
+
+
+def test_estimate_resources_presubdivision():
+    """Test the working face count against upstream's split length."""
+    import pyquadriflow
+
+    verts = np.array([[0, 0, 0], [1, 0, 0], [0.5, np.sqrt(3) / 2, 0]], dtype=np.float64)
+    faces = np.array([[0, 1, 2]], dtype=np.int32)
+    est = pyquadriflow.estimate_resources(verts, faces, target_faces=100)
+
+    # Parametrizer::Initialize: scale = sqrt(area / faces) / 2, split at scale / 2
+    target_len = np.sqrt(est["surface_area"] / 100) / 4
+    assert est["working_faces"] == np.ceil(1 / target_len) ** 2
+
+
+def test_estimate_resources_open_mesh(icosphere):
+    """Test that removing faces produces boundary edges."""
+    import pyquadriflow
+
+    verts, faces = icosphere
+    est = pyquadriflow.estimate_resources(verts, faces[:-10], target_faces=100)
+
+    assert est["num_boundary_edges"] > 0
+    assert est["boundary_length"] > 0
+
+
+def test_estimate_resources_monotonic(icosphere):
+    """Test that more output faces and costlier flags predict more work."""
+    import pyquadriflow
+
+    verts, faces = icosphere
+    small = pyquadriflow.estimate_resources(verts, faces, target_faces=100)
+    large = pyquadriflow.estimate_resources(verts, faces, target_faces=10000)
+    flow = pyquadriflow.estimate_resources(
+        verts, faces, target_faces=100, minimum_cost_flow=True)
+
+    assert large["runtime_seconds"] > small["runtime_seconds"]
+    assert large["peak_memory_bytes"] > small["peak_memory_bytes"]
+    assert flow["runtime_seconds"] > small["runtime_seconds"]
+
+
+def test_estimate_resources_cost_model(icosphere):
+    """Test cost model coefficient overrides and validation."""
+    import pyquadriflow
+
+    verts, faces = icosphere
+    est = pyquadriflow.estimate_resources(
+        verts, faces, target_faces=100,
+        cost_model={"base_bytes": 0, "bytes_per_input_face": 0,
+                    "bytes_per_working_vertex": 0})
+    assert est["peak_memory_bytes"] == 0
+
+    with pytest.raises(ValueError):
+        pyquadriflow.estimate_resources(
+            verts, faces, target_faces=100, cost_model={"bogus": 1.0})